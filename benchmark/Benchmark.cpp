@@ -0,0 +1,269 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include "RealtimeCheck.h"
+#include "FXCheck.h"
+
+//==============================================================================
+/*  Headless editor benchmark
+
+    Opens the editor offscreen and paints it into software images at 60 Hz
+    while an audio thread renders held chords in real time, then prints the
+    paint time of the heavier components. No window is ever put on the desktop,
+    so it runs without a display server.
+
+    Options:
+        --seconds <n>   how long to run, default 10
+        --voices <n>    notes held at once, default 8
+        --scale <n>     render scale, 2 for a retina / hi-dpi display, default 1
+
+    Built with WAVETABLE_TRACING, --trace <file> also records a Chrome trace
+    of the run.
+
+    With --rt-check it instead runs the real-time safety scenarios in
+    RealtimeCheck.cpp and exits non-zero on any violation:
+        --blocks <n>    blocks per scenario, default 400
+
+    With --fx-check it instead compares the Airwindows effects against their
+    double precision reference, see FXCheck.cpp:
+        --blocks <n>    blocks per comparison, default 200
+*/
+
+//==============================================================================
+/** Stands in for the audio device, rendering blocks at the rate a host would */
+class AudioDriver : public juce::Thread
+{
+public:
+    AudioDriver (WavetableAudioProcessor& p, double sr, int bs, int nv)
+        : juce::Thread ("Benchmark Audio"), proc (p), sampleRate (sr), blockSize (bs), numVoices (nv)
+    {
+    }
+
+    ~AudioDriver() override
+    {
+        stopThread (2000);
+    }
+
+    void run() override
+    {
+        juce::AudioSampleBuffer buffer (2, blockSize);
+        juce::MidiBuffer midi;
+
+        auto blockMs = 1000.0 * blockSize / sampleRate;
+        auto notesEvery = int (2.0 * sampleRate / blockSize);
+        auto nextBlock = juce::Time::getMillisecondCounterHiRes();
+
+        for (int block = 0; ! threadShouldExit(); block++)
+        {
+            // Retrigger the chord every couple of seconds so envelopes and LFOs keep moving
+            midi.clear();
+            if (block % notesEvery == 0)
+            {
+                for (int i = 0; i < numVoices; i++)
+                {
+                    if (block > 0)
+                        midi.addEvent (juce::MidiMessage::noteOff (1, 48 + i * 3), 0);
+                    midi.addEvent (juce::MidiMessage::noteOn (1, 48 + i * 3, 0.8f), 1);
+                }
+            }
+
+            buffer.clear();
+
+            auto start = juce::Time::getHighResolutionTicks();
+            proc.processBlock (buffer, midi);
+            auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+            {
+                const juce::SpinLock::ScopedLockType sl (statsLock);
+                stats.addValue (elapsed * 1000.0);
+            }
+
+            nextBlock += blockMs;
+            auto wait = nextBlock - juce::Time::getMillisecondCounterHiRes();
+            if (wait > 0)
+                juce::Thread::sleep (int (wait));
+        }
+    }
+
+    juce::StatisticsAccumulator<double> getStats()
+    {
+        const juce::SpinLock::ScopedLockType sl (statsLock);
+        return stats;
+    }
+
+private:
+    WavetableAudioProcessor& proc;
+    double sampleRate;
+    int blockSize, numVoices;
+
+    juce::SpinLock statsLock;
+    juce::StatisticsAccumulator<double> stats;
+};
+
+//==============================================================================
+class EditorBenchmark : private juce::Timer
+{
+public:
+    EditorBenchmark (double seconds, int voices, float scale_)
+        : totalTicks (juce::roundToInt (seconds * 60.0)), scale (scale_)
+    {
+        proc.setRateAndBufferSizeDetails (sampleRate, blockSize);
+        proc.prepareToPlay (sampleRate, blockSize);
+
+        editor.reset (proc.createEditorIfNeeded());
+        editor->setVisible (true);
+
+        addTarget<OscillatorBox> ("OscillatorBox");
+        addTarget<FilterBox> ("FilterBox");
+        addTarget<gin::TriggeredScope> ("scope");
+        addTarget<gin::ModulationOverview> ("ModulationOverview");
+        addTarget<MatrixBox> ("MatrixBox");
+        targets.add ({ "Editor (all)", editor.get(), {} });
+
+        audio = std::make_unique<AudioDriver> (proc, sampleRate, blockSize, voices);
+    }
+
+    ~EditorBenchmark() override
+    {
+        stopTimer();
+        audio = nullptr;
+        editor = nullptr;
+        proc.releaseResources();
+    }
+
+    void start()
+    {
+        audio->startThread (juce::Thread::Priority::highest);
+        startTimerHz (60);
+    }
+
+    void printReport()
+    {
+        printf ("Editor %dx%d at %.1fx, %d ticks\n\n", editor->getWidth(), editor->getHeight(), scale, ticks);
+        printf ("%-22s %10s %10s %10s\n", "Component", "avg ms", "max ms", "% of 60Hz");
+
+        for (auto& t : targets)
+        {
+            if (t.component == nullptr)
+            {
+                printf ("%-22s %10s\n", t.name.toRawUTF8(), "not found");
+                continue;
+            }
+
+            printf ("%-22s %10.3f %10.3f %9.1f%%\n", t.name.toRawUTF8(),
+                    t.stats.getAverage(), t.stats.getMaxValue(), t.stats.getAverage() / (1000.0 / 60.0) * 100.0);
+        }
+
+        auto a = audio->getStats();
+        auto blockMs = 1000.0 * blockSize / sampleRate;
+        printf ("\nAudio: %d blocks of %d, avg %.3f ms, max %.3f ms, budget %.3f ms\n",
+                int (a.getCount()), blockSize, a.getAverage(), a.getMaxValue(), blockMs);
+
+        auto d = proc.getDropoutStats();
+        printf ("Dropouts: %d missed, %d voice kills, %d over deadline, worst render %.3f ms\n",
+                int (d.missedBlocks), int (d.voiceKills), int (d.overDeadline), d.worstRenderMs);
+    }
+
+private:
+    struct Target
+    {
+        juce::String name;
+        juce::Component* component = nullptr;
+        juce::StatisticsAccumulator<double> stats;
+    };
+
+    template <typename T>
+    void addTarget (const juce::String& name)
+    {
+        targets.add ({ name, findChild<T> (*editor), {} });
+    }
+
+    template <typename T>
+    static juce::Component* findChild (juce::Component& parent)
+    {
+        for (auto c : parent.getChildren())
+        {
+            if (dynamic_cast<T*> (c) != nullptr)
+                return c;
+
+            if (auto found = findChild<T> (*c))
+                return found;
+        }
+        return nullptr;
+    }
+
+    void timerCallback() override
+    {
+        for (auto& t : targets)
+        {
+            if (t.component == nullptr)
+                continue;
+
+            auto start = juce::Time::getHighResolutionTicks();
+            auto image = t.component->createComponentSnapshot (t.component->getLocalBounds(), true, scale);
+            auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+            t.stats.addValue (elapsed * 1000.0);
+        }
+
+        if (++ticks >= totalTicks)
+        {
+            stopTimer();
+            juce::MessageManager::getInstance()->stopDispatchLoop();
+        }
+    }
+
+    const double sampleRate = 44100.0;
+    const int blockSize = 256;
+
+    WavetableAudioProcessor proc;
+    std::unique_ptr<juce::AudioProcessorEditor> editor;
+    std::unique_ptr<AudioDriver> audio;
+
+    juce::Array<Target> targets;
+    int ticks = 0, totalTicks;
+    float scale;
+};
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+
+    auto option = [&] (const char* name, double def)
+    {
+        return args.containsOption (name) ? args.getValueForOption (name).getDoubleValue() : def;
+    };
+
+    // Plain DSP, no processor or message loop needed
+    if (args.containsOption ("--fx-check"))
+        return runFXCheck (args);
+
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+   #if WT_TRACING
+    if (args.containsOption ("--trace"))
+        Trace::start (juce::File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--trace")));
+   #endif
+
+    if (args.containsOption ("--rt-check"))
+    {
+        auto result = runRealtimeCheck (args);
+       #if WT_TRACING
+        Trace::stop();
+       #endif
+        return result;
+    }
+
+    EditorBenchmark benchmark (option ("--seconds", 10.0), int (option ("--voices", 8.0)), float (option ("--scale", 1.0)));
+    benchmark.start();
+
+    juce::MessageManager::getInstance()->runDispatchLoop();
+
+   #if WT_TRACING
+    Trace::stop();
+   #endif
+
+    benchmark.printReport();
+    return 0;
+}
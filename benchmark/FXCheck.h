@@ -0,0 +1,13 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Runs the Airwindows effects' processReplacing against their
+    processDoubleReplacing reference over seeded noise at each supported
+    sample rate. The stereo-pair kernels have to match the per-channel
+    reference to within rounding to float, and FireAmp and GrindAmp in float
+    mode to within the bounds quoted next to their float state. Returns
+    non-zero if any don't.
+*/
+int runFXCheck (const juce::ArgumentList& args);
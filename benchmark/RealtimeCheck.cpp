@@ -0,0 +1,469 @@
+#include "RealtimeCheck.h"
+#include "PluginProcessor.h"
+
+#if ! JUCE_WINDOWS
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+#if WAVETABLE_RTSAN
+extern "C" void __rtsan_realtime_enter();
+extern "C" void __rtsan_realtime_exit();
+#endif
+
+//==============================================================================
+namespace rt
+{
+    thread_local bool inCallback = false;
+
+    std::atomic<int> allocations { 0 }, frees { 0 }, locks { 0 };
+
+    struct ScopedCallback
+    {
+        ScopedCallback()
+        {
+            inCallback = true;
+           #if WAVETABLE_RTSAN
+            __rtsan_realtime_enter();
+           #endif
+        }
+
+        ~ScopedCallback()
+        {
+           #if WAVETABLE_RTSAN
+            __rtsan_realtime_exit();
+           #endif
+            inCallback = false;
+        }
+    };
+}
+
+#if ! JUCE_WINDOWS
+//==============================================================================
+// Replacements for every form of operator new and delete, so a violation is
+// counted whichever one the code under test happens to use.
+namespace
+{
+    void* allocate (std::size_t n, std::size_t align = 0)
+    {
+        if (rt::inCallback)
+            rt::allocations++;
+
+        if (n == 0)
+            n = 1;
+
+        if (align > alignof (std::max_align_t))
+        {
+            void* p = nullptr;
+            return posix_memalign (&p, align, n) == 0 ? p : nullptr;
+        }
+        return std::malloc (n);
+    }
+
+    void release (void* p)
+    {
+        if (p != nullptr && rt::inCallback)
+            rt::frees++;
+
+        std::free (p);
+    }
+
+    void* allocateOrThrow (std::size_t n, std::size_t align = 0)
+    {
+        if (auto p = allocate (n, align))
+            return p;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new (std::size_t n)                                              { return allocateOrThrow (n); }
+void* operator new[] (std::size_t n)                                            { return allocateOrThrow (n); }
+void* operator new (std::size_t n, const std::nothrow_t&) noexcept              { return allocate (n); }
+void* operator new[] (std::size_t n, const std::nothrow_t&) noexcept            { return allocate (n); }
+void* operator new (std::size_t n, std::align_val_t a)                          { return allocateOrThrow (n, std::size_t (a)); }
+void* operator new[] (std::size_t n, std::align_val_t a)                        { return allocateOrThrow (n, std::size_t (a)); }
+void* operator new (std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept     { return allocate (n, std::size_t (a)); }
+void* operator new[] (std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept   { return allocate (n, std::size_t (a)); }
+
+void operator delete (void* p) noexcept                                         { release (p); }
+void operator delete[] (void* p) noexcept                                       { release (p); }
+void operator delete (void* p, std::size_t) noexcept                            { release (p); }
+void operator delete[] (void* p, std::size_t) noexcept                          { release (p); }
+void operator delete (void* p, const std::nothrow_t&) noexcept                  { release (p); }
+void operator delete[] (void* p, const std::nothrow_t&) noexcept                { release (p); }
+void operator delete (void* p, std::align_val_t) noexcept                       { release (p); }
+void operator delete[] (void* p, std::align_val_t) noexcept                     { release (p); }
+void operator delete (void* p, std::size_t, std::align_val_t) noexcept          { release (p); }
+void operator delete[] (void* p, std::size_t, std::align_val_t) noexcept        { release (p); }
+void operator delete (void* p, std::align_val_t, const std::nothrow_t&) noexcept    { release (p); }
+void operator delete[] (void* p, std::align_val_t, const std::nothrow_t&) noexcept  { release (p); }
+
+// juce::CriticalSection, std::mutex and WaitableEvent all end up here. Looked
+// up without a function static, whose guard could itself take a lock.
+extern "C" int pthread_mutex_lock (pthread_mutex_t* m)
+{
+    using LockFn = int (*) (pthread_mutex_t*);
+    static LockFn realLock = nullptr;
+
+    if (realLock == nullptr)
+        realLock = (LockFn) dlsym (RTLD_NEXT, "pthread_mutex_lock");
+
+    if (rt::inCallback)
+        rt::locks++;
+
+    return realLock (m);
+}
+#endif
+
+//==============================================================================
+namespace
+{
+    /** A host transport the scenarios can change tempo on */
+    struct ScriptedPlayHead : public juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override  { return info; }
+
+        PositionInfo info;
+    };
+
+    struct Scenario
+    {
+        const char* name;
+
+        // Runs before each block as the host would, outside the callback
+        std::function<void (int block, int numBlocks, juce::MidiBuffer&)> step;
+
+        // Optional, looks at each block's output and returns false if it's wrong
+        std::function<bool (int block, const juce::AudioSampleBuffer&)> check;
+    };
+
+    struct Result
+    {
+        int allocations = 0, frees = 0, locks = 0, badBlocks = 0;
+
+        bool passed() const     { return allocations == 0 && frees == 0 && locks == 0 && badBlocks == 0; }
+    };
+
+    Result runScenario (WavetableAudioProcessor& proc, const Scenario& s, int numBlocks, int blockSize)
+    {
+        juce::AudioSampleBuffer buffer (2, blockSize);
+        juce::MidiBuffer midi;
+        midi.ensureSize (4096);
+
+        rt::allocations = rt::frees = rt::locks = 0;
+        int badBlocks = 0;
+
+        for (int block = 0; block < numBlocks; block++)
+        {
+            midi.clear();
+            s.step (block, numBlocks, midi);
+
+            buffer.clear();
+
+            {
+                rt::ScopedCallback cb;
+                proc.processBlock (buffer, midi);
+            }
+
+            if (s.check && ! s.check (block, buffer))
+                badBlocks++;
+        }
+
+        // All notes off, so the next scenario starts from silence
+        midi.clear();
+        for (int ch = 1; ch <= 16; ch++)
+            midi.addEvent (juce::MidiMessage::allNotesOff (ch), 0);
+        proc.processBlock (buffer, midi);
+
+        return { rt::allocations.load(), rt::frees.load(), rt::locks.load(), badBlocks };
+    }
+
+    std::vector<Scenario> createScenarios (WavetableAudioProcessor& proc, ScriptedPlayHead& transport)
+    {
+        auto random = std::make_shared<juce::Random> (1234);
+
+        auto state = std::make_shared<juce::MemoryBlock>();
+        proc.getStateInformation (*state);
+
+        std::vector<Scenario> scenarios;
+
+        scenarios.push_back ({ "note storm", [random] (int, int, juce::MidiBuffer& midi)
+        {
+            for (int i = 0; i < 16; i++)
+            {
+                auto note = 24 + random->nextInt (72);
+                auto pos = random->nextInt (256);
+
+                if (random->nextBool())
+                    midi.addEvent (juce::MidiMessage::noteOn (1, note, juce::uint8 (1 + random->nextInt (127))), pos);
+                else
+                    midi.addEvent (juce::MidiMessage::noteOff (1, note), pos);
+            }
+        }});
+
+        scenarios.push_back ({ "preset loads", [&proc, state] (int block, int, juce::MidiBuffer& midi)
+        {
+            if (block % 20 == 0)
+            {
+                auto numPrograms = proc.getNumPrograms();
+                if (numPrograms > 1 && block % 40 == 0)
+                    proc.setCurrentProgram ((block / 40) % numPrograms);
+                else
+                    proc.setStateInformation (state->getData(), int (state->getSize()));
+            }
+
+            if (block % 20 == 1)
+                for (int i = 0; i < 6; i++)
+                    midi.addEvent (juce::MidiMessage::noteOn (1, 48 + i * 4, 0.8f), 0);
+        }});
+
+        scenarios.push_back ({ "wavetable switches", [&proc] (int block, int, juce::MidiBuffer& midi)
+        {
+            if (block == 0)
+                for (int i = 0; i < 6; i++)
+                    midi.addEvent (juce::MidiMessage::noteOn (1, 48 + i * 4, 0.8f), 0);
+
+            if (block % 10 == 5)
+                proc.incWavetable (block % 20 == 5 ? 0 : 1, 1);
+        }});
+
+        scenarios.push_back ({ "mpe", [&proc, random] (int block, int numBlocks, juce::MidiBuffer& midi)
+        {
+            if (block == 0)
+                proc.globalParams.mpe->setUserValue (1.0f);
+
+            for (int ch = 2; ch <= 9; ch++)
+            {
+                if (block % 40 == 0)
+                    midi.addEvent (juce::MidiMessage::noteOn (ch, 40 + ch * 3, 0.7f), 0);
+                else if (block % 40 == 39)
+                    midi.addEvent (juce::MidiMessage::noteOff (ch, 40 + ch * 3), 255);
+
+                midi.addEvent (juce::MidiMessage::pitchWheel (ch, 8192 + random->nextInt (2048) - 1024), 64);
+                midi.addEvent (juce::MidiMessage::channelPressureChange (ch, random->nextInt (128)), 128);
+                midi.addEvent (juce::MidiMessage::controllerEvent (ch, 74, random->nextInt (128)), 192);
+            }
+
+            if (block == numBlocks - 1)
+                proc.globalParams.mpe->setUserValue (0.0f);
+        }});
+
+        scenarios.push_back ({ "sync changes", [&proc, &transport] (int block, int, juce::MidiBuffer& midi)
+        {
+            if (block == 0)
+            {
+                for (int i = 0; i < 6; i++)
+                    midi.addEvent (juce::MidiMessage::noteOn (1, 48 + i * 4, 0.8f), 0);
+
+                for (auto& l : proc.lfoParams)
+                    l.enable->setUserValue (1.0f);
+
+                proc.stepLfoParams.enable->setUserValue (1.0f);
+                proc.gateParams.enable->setUserValue (1.0f);
+                proc.delayParams.enable->setUserValue (1.0f);
+            }
+
+            transport.info.setBpm (90.0 + (block % 100));
+
+            if (block % 25 == 0)
+            {
+                auto on = (block / 25) % 2 == 0 ? 1.0f : 0.0f;
+
+                for (auto& l : proc.lfoParams)
+                    l.sync->setUserValue (on);
+
+                proc.delayParams.sync->setUserValue (on);
+            }
+        }});
+
+        // The oversampling filters stay in the chain while the distortion is
+        // off, the latency is reported from the message thread meanwhile
+        scenarios.push_back ({ "distortion toggles", [&proc] (int block, int numBlocks, juce::MidiBuffer& midi)
+        {
+            if (block == 0)
+                for (int i = 0; i < 6; i++)
+                    midi.addEvent (juce::MidiMessage::noteOn (1, 48 + i * 4, 0.8f), 0);
+
+            if (block % 10 == 0)
+                proc.distortionParams.enable->setUserValue ((block / 10) % 2 == 0 ? 1.0f : 0.0f);
+
+            if (block % 25 == 0)
+                proc.fxParams.distOversample->setUserValue (float ((block / 25) % 3));
+
+            if (block % 50 == 0)
+                proc.fxParams.distMode->setUserValue (float ((block / 50) % 4));
+
+            if (block == numBlocks - 1)
+            {
+                proc.distortionParams.enable->setUserValue (0.0f);
+                proc.fxParams.distOversample->setUserValue (0.0f);
+            }
+        }});
+
+        // Voices cut dead with 4x oversampling on leave their last samples in
+        // the filters. Those have to come out before the processor goes idle,
+        // not at the start of the next note.
+        scenarios.push_back ({ "idle and resume", [&proc] (int block, int numBlocks, juce::MidiBuffer& midi)
+        {
+            const int period = 40;
+
+            if (block == 0)
+            {
+                proc.gateParams.enable->setUserValue (0.0f);
+                proc.chorusParams.enable->setUserValue (0.0f);
+                proc.delayParams.enable->setUserValue (0.0f);
+                proc.reverbParams.enable->setUserValue (0.0f);
+                proc.fxParams.distOversample->setUserValue (2.0f);
+            }
+
+            if (block % period == 0)
+                for (int i = 0; i < 6; i++)
+                    midi.addEvent (juce::MidiMessage::noteOn (1, 48 + i * 4, 0.8f), 128);
+
+            // Toggling mono turns every voice off without a release
+            if (block % period == period / 2)
+                proc.globalParams.mono->setUserValue (proc.globalParams.mono->isOn() ? 0.0f : 1.0f);
+
+            if (block == numBlocks - 1)
+            {
+                proc.globalParams.mono->setUserValue (0.0f);
+                proc.fxParams.distOversample->setUserValue (0.0f);
+            }
+        },
+        [] (int block, const juce::AudioSampleBuffer& buffer)
+        {
+            const int period = 40;
+
+            // Silent from a few blocks after the cut, which leaves time for the
+            // flush and the FX thread's block of delay, up to the next note
+            auto phase = block % period;
+            int num = 0;
+
+            if (block >= period && phase == 0)
+                num = 128;
+            else if (phase >= period / 2 + 4)
+                num = buffer.getNumSamples();
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ch++)
+                if (buffer.getMagnitude (ch, 0, num) > 1.0e-6f)
+                    return false;
+
+            return true;
+        }});
+
+        // Switching happens on the audio thread at the start of a block
+        scenarios.push_back ({ "fx thread toggles", [&proc] (int block, int, juce::MidiBuffer& midi)
+        {
+            if (block == 0)
+            {
+                for (int i = 0; i < 6; i++)
+                    midi.addEvent (juce::MidiMessage::noteOn (1, 48 + i * 4, 0.8f), 0);
+
+                proc.delayParams.enable->setUserValue (1.0f);
+                proc.reverbParams.enable->setUserValue (1.0f);
+            }
+
+            if (block % 30 == 0)
+                proc.setFXThreadEnabled (! proc.isFXThreadEnabled());
+        }});
+
+        return scenarios;
+    }
+
+    /** Runs the scenarios on their own thread while this one keeps the message loop going */
+    class Runner : public juce::Thread
+    {
+    public:
+        Runner (int blocks) : juce::Thread ("Realtime Check"), numBlocks (blocks) {}
+
+        ~Runner() override
+        {
+            stopThread (10000);
+        }
+
+        void run() override
+        {
+            const double sampleRate = 48000.0;
+            const int blockSize = 256;
+
+            WavetableAudioProcessor proc;
+
+            ScriptedPlayHead transport;
+            transport.info.setIsPlaying (true);
+            transport.info.setBpm (120.0);
+            proc.setPlayHead (&transport);
+
+            // The FX worker is realtime too, count what it does as well
+            proc.fxPipeline.onProcess = [process = proc.fxPipeline.onProcess] (juce::AudioSampleBuffer& buffer)
+            {
+                rt::ScopedCallback cb;
+                process (buffer);
+            };
+
+            proc.setRateAndBufferSizeDetails (sampleRate, blockSize);
+            proc.prepareToPlay (sampleRate, blockSize);
+
+            // Everything with the effects inline, then again on the FX thread
+            for (auto fxThread : { false, true })
+            {
+                proc.setFXThreadEnabled (fxThread);
+
+                // Without a realtime thread the effects would run inline, which
+                // has already been checked
+                if (fxThread && ! proc.fxPipeline.isRunning())
+                {
+                    printf ("%-32s %8s %8s %8s  skipped, the FX thread couldn't be started\n", "(fx thread)", "-", "-", "-");
+                    break;
+                }
+
+                for (auto& s : createScenarios (proc, transport))
+                {
+                    if (threadShouldExit())
+                        break;
+
+                    auto r = runScenario (proc, s, numBlocks, blockSize);
+
+                    auto name = juce::String (s.name) + (fxThread ? " (fx thread)" : "");
+                    printf ("%-32s %8d %8d %8d  %s\n", name.toRawUTF8(), r.allocations, r.frees, r.locks, r.passed() ? "ok" : "FAIL");
+                    if (! r.passed())
+                        failed = true;
+                }
+            }
+
+            auto d = proc.getDropoutStats();
+            printf ("\nDropouts: %d missed, %d voice kills, %d over deadline, worst render %.3f ms\n",
+                    int (d.missedBlocks), int (d.voiceKills), int (d.overDeadline), d.worstRenderMs);
+
+            proc.releaseResources();
+
+            juce::MessageManager::callAsync ([] { juce::MessageManager::getInstance()->stopDispatchLoop(); });
+        }
+
+        std::atomic<bool> failed { false };
+
+    private:
+        int numBlocks;
+    };
+}
+
+//==============================================================================
+int runRealtimeCheck (const juce::ArgumentList& args)
+{
+   #if JUCE_WINDOWS
+    juce::ignoreUnused (args);
+    printf ("The allocation and lock checks aren't available on Windows\n");
+    return 0;
+   #else
+    auto blocks = args.containsOption ("--blocks") ? args.getValueForOption ("--blocks").getIntValue() : 400;
+
+    printf ("%-32s %8s %8s %8s\n", "Scenario", "allocs", "frees", "locks");
+
+    Runner runner (blocks);
+    runner.startThread();
+
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    runner.waitForThreadToExit (-1);
+
+    return runner.failed ? 1 : 0;
+   #endif
+}
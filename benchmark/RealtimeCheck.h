@@ -0,0 +1,17 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Runs the processor through scripted scenarios and counts the allocations,
+    frees and mutex locks made inside processBlock and in the FX worker's
+    jobs. Some scenarios also check the output is silent where it should be.
+    Returns non-zero if anything failed, so it can gate a build.
+
+    Allocations are caught by replacing operator new / delete, locks by
+    interposing pthread_mutex_lock, neither is available on Windows. Built with
+    WAVETABLE_RTSAN each callback and job is also marked real-time for
+    RealtimeSanitizer, which catches malloc and blocking system calls too and
+    stops at the first one.
+*/
+int runRealtimeCheck (const juce::ArgumentList& args);
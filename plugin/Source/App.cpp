@@ -22,6 +22,8 @@ static void profile (juce::PropertiesFile& settings)
     juce::MidiBuffer midiOff;
     juce::MidiBuffer midiEmpty;
     
+    proc.modProfiler.setEnabled (true);
+
     auto start = juce::Time::getMillisecondCounterHiRes();
     
     for (int i = 0; i < 20000; i++)
@@ -55,6 +57,8 @@ static void profile (juce::PropertiesFile& settings)
     
     auto end = juce::Time::getMillisecondCounterHiRes();
     printf ("Elapsed time: %.2fs\n", (end - start) / 1000);
+    printf ("%s\n", proc.modProfiler.getReport().toString().toRawUTF8());
+    printf ("Idle blocks: %.1f%%\n", proc.getIdleRatio() * 100.0);
 }
 
 #endif
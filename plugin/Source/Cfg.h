@@ -2,6 +2,7 @@
 
 namespace Cfg
 {
+    constexpr static int numVoices  = 50;
     constexpr static int numOSCs    = 2;
     constexpr static int numENVs    = 3;
     constexpr static int numLFOs    = 3;
@@ -36,7 +36,7 @@ Editor::Editor (WavetableAudioProcessor& proc_)
         proc.fxParams.fx4->setUserValue (fx.getChildComponent(3)->getProperties()["fxId"]);
         proc.fxParams.fx5->setUserValue (fx.getChildComponent(4)->getProperties()["fxId"]);
 
-        handleAsyncUpdate();
+        updateFxOrder();
     };
 
     proc.fxParams.fx1->addListener (this);
@@ -48,7 +48,7 @@ Editor::Editor (WavetableAudioProcessor& proc_)
     addAndMakeVisible (fx);
 
     setupCallbacks();
-    handleAsyncUpdate();
+    updateFxOrder();
 }
 
 Editor::~Editor()
@@ -60,11 +60,34 @@ Editor::~Editor()
     proc.fxParams.fx5->removeListener (this);
 }
 
-void Editor::handleAsyncUpdate()
+void Editor::valueUpdated (gin::Parameter*)
 {
+    paramChanges++;
+    dirty |= fxOrderDirty;
+}
+
+void Editor::flushUpdates()
+{
+    WT_TRACE_SCOPE ("Editor flushUpdates");
+
+    // Left marked until the drag is over
     if (fx.isDragInProgress())
         return;
-    
+
+    auto flags = dirty.exchange (0);
+
+    if (flags & fxOrderDirty)
+        updateFxOrder();
+}
+
+void Editor::updateFxOrder()
+{
+    if (fx.isDragInProgress())
+        return;
+
+    WT_TRACE_SCOPE ("Editor updateFxOrder");
+
+    layoutUpdates++;
     fx.removeAllChildren();
 
     auto getComp = [this] (int fxId) -> juce::Component*
@@ -103,5 +126,5 @@ void Editor::resized()
     layout.setLayout (juce::StringArray ("layout.json"));
    #endif
     
-    handleAsyncUpdate();
+    updateFxOrder();
 }
@@ -6,8 +6,7 @@
 
 //==============================================================================
 class Editor : public juce::Component,
-               private gin::Parameter::ParameterListener,
-               private juce::AsyncUpdater
+               private gin::Parameter::ParameterListener
 {
 public:
     Editor (WavetableAudioProcessor& proc_);
@@ -16,9 +15,26 @@ public:
     void setupCallbacks();
     void resized() override;
 
+    /** Watched parameter changes received, and the layout passes they were
+        folded into. For profiling, both only ever go up. */
+    int getParamChangeCount() const     { return paramChanges.load(); }
+    int getLayoutUpdateCount() const    { return layoutUpdates; }
+
 private:
-    void valueUpdated (gin::Parameter*) override { triggerAsyncUpdate(); }
-    void handleAsyncUpdate() override;
+    // Any thread. Changes only mark what needs redoing, it's done once per vsync.
+    void valueUpdated (gin::Parameter*) override;
+    void flushUpdates();
+
+    void updateFxOrder();
+
+    enum DirtyFlags : uint32_t
+    {
+        fxOrderDirty = 1 << 0,
+    };
+
+    std::atomic<uint32_t> dirty { 0 };
+    std::atomic<int> paramChanges { 0 };
+    int layoutUpdates = 0;
 
     WavetableAudioProcessor& proc;
 
@@ -45,4 +61,6 @@ private:
     gin::ComponentGrid fx { "fx" };
 
     gin::LayoutSupport layout { *this };
+
+    juce::VBlankAttachment vblank { this, [this] { flushUpdates(); } };
 };
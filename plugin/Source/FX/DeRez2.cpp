@@ -72,6 +72,9 @@ void DeRez2::reset()
 	incrementB = 0.0;
 	fpdL = 1.0; while (fpdL < 16386) fpdL = rand()*UINT32_MAX;
 	fpdR = 1.0; while (fpdR < 16386) fpdR = rand()*UINT32_MAX;
+
+	stereo = {};
+	coefficients = {};
 }
 
 static float pinParameter(float data)
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "FXBase.h"
+#include "StereoPair.h"
 
 #include <set>
 #include <string>
@@ -65,6 +66,29 @@ private:
 	double incrementA;
 	double incrementB;
 	
+	struct StereoState
+	{
+		StereoPair<double> lastSample;
+		StereoPair<double> heldSample;
+		StereoPair<double> lastDrySample;
+		StereoPair<double> lastOutputSample;
+
+		double position = 0.0;
+		double incrementA = 0.0;
+		double incrementB = 0.0;
+	};
+	StereoState stereo; //both channels as lanes of one pair, used by processReplacing
+
+	struct Coefficients
+	{
+		float A = -1.0f, B = -1.0f, C = -1.0f, D = -1.0f;
+		double sampleRate = 0.0; //what everything below was derived from
+
+		double targetA, soften, targetB, hard, wet;
+	};
+	Coefficients coefficients;
+	void updateCoefficients(); //refreshes coefficients when A..D or the rate move
+
 	uint32_t fpdL;
 	uint32_t fpdR;
 	//default stuff
@@ -72,6 +72,11 @@ public:
     int getNumOutputs()                 { return numOutputs;    }
     int getNumParameters()              { return numParams;     }
 
+    /** Takes the sample rate from the callback, call from prepareToPlay so
+        processing reads a plain member. Pass the oversampling factor when the
+        effect runs oversampled. */
+    void updateSampleRate (int oversampling = 1)    { sampleRate = callback.getSampleRate() * oversampling; }
+
     //==============================================================================
     virtual bool getEffectName(char* name)                        = 0;
     virtual VstPlugCategory getPlugCategory()                     = 0;
@@ -91,6 +96,10 @@ public:
     virtual void getParameterDisplay(VstInt32 index, char* text)                    { juce::ignoreUnused (index, text); }
     virtual VstInt32 canDo(char *text)                            = 0;
 
+    /** Chooses double or float state for processReplacing, effects without a
+        float path ignore it */
+    virtual void setDoublePrecision (bool shouldUseDouble)                         { juce::ignoreUnused (shouldUseDouble); }
+
 protected:
     //==============================================================================
     void setNumInputs (int numIn)       { numInputs = numIn;    }
@@ -104,5 +113,7 @@ protected:
 
     FXBaseCallback callback;
 
-    double getSampleRate()              { return callback.getSampleRate(); }
+    double sampleRate = 44100.0;
+
+    double getSampleRate()              { return sampleRate; }
 };
@@ -237,6 +237,23 @@ void FireAmp::reset()
 	fpdL = 1.0; while (fpdL < 16386) fpdL = rand()*UINT32_MAX;
 	fpdR = 1.0; while (fpdR < 16386) fpdR = rand()*UINT32_MAX;
 	//this is reset: values being initialized only once. Startup values, whatever they are.
+
+	stereo = {};
+	stereoFloat = {};
+	coefficients = {};
+}
+
+void FireAmp::setDoublePrecision (bool shouldUseDouble)
+{
+	if (doublePrecision == shouldUseDouble)
+		return;
+
+	doublePrecision = shouldUseDouble;
+
+	//the state doesn't carry across, start the new one clean
+	stereo = {};
+	stereoFloat = {};
+	coefficients = {};
 }
 
 static float pinParameter(float data)
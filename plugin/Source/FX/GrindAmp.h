@@ -7,6 +7,7 @@
 #pragma once
 
 #include "FXBase.h"
+#include "StereoPair.h"
 
 #include <set>
 #include <string>
@@ -37,6 +38,7 @@ public:
     VstInt32 getVendorVersion();                          // Version number
     void processReplacing (float** inputs, float** outputs, VstInt32 sampleFrames);
     void processDoubleReplacing (double** inputs, double** outputs, VstInt32 sampleFrames);
+    void setDoublePrecision (bool shouldUseDouble) override;
     void getProgramName(char *name);                      // read the name from the host
     void setProgramName(char *name);                      // changes the name of the preset displayed in the host
 	VstInt32 getChunk (void** data, bool isPreset);
@@ -178,6 +180,45 @@ private:
 	double fixE[fix_total];
 	double fixF[fix_total]; //filtering
 	
+	template <typename T>
+	struct StereoState
+	{
+		static constexpr int cabSize = 84;
+
+		StereoPair<T> smooth[11];
+		StereoPair<T> second[11];
+		StereoPair<T> third[11];
+		StereoPair<T> iirSample[9];
+		StereoPair<T> storeSample; //amp
+
+		StereoPair<T> cab[2 * cabSize]; //written twice so taps read contiguously
+		int cabPos = 0;
+		StereoPair<T> lastCabSample, smoothCabA, smoothCabB; //cab
+
+		StereoPair<T> lastRef[10];
+		int cycle = 0; //undersampling
+
+		StereoBiquad<T> fix[6]; //filtering
+	};
+	StereoState<double> stereo; //both channels as lanes of one pair, used by processReplacing
+	StereoState<float> stereoFloat; //single precision, within 2e-4 (-74 dBFS) of stereo, checked by the benchmark's --fx-check
+	bool doublePrecision = true;
+
+	template <typename T>
+	void processStereo (StereoState<T>& st, float** inputs, float** outputs, VstInt32 sampleFrames);
+
+	struct Coefficients
+	{
+		float A = -1.0f, B = -1.0f, C = -1.0f, D = -1.0f;
+		double sampleRate = 0.0; //what everything below was derived from
+
+		int cycleEnd;
+		double inputlevel, toneEQ, EQ, BEQ, outputlevel, wet, bassdrive;
+		StereoPair<double> randyAmp, randyCab;
+	};
+	Coefficients coefficients;
+	void updateCoefficients(); //refreshes coefficients and the stereo biquads when A..D or the rate move
+
 	uint32_t fpdL;
 	uint32_t fpdR;
 	//default stuff
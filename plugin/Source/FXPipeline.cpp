@@ -0,0 +1,136 @@
+#include "FXPipeline.h"
+#include "Trace.h"
+
+//==============================================================================
+FXPipeline::FXPipeline()
+    : juce::Thread ("FX Pipeline")
+{
+}
+
+FXPipeline::~FXPipeline()
+{
+    stop();
+}
+
+bool FXPipeline::start (int numChannels, int maxJobSize)
+{
+    stop();
+
+    latency = maxJobSize;
+    job.setSize (numChannels, maxJobSize);
+    output.setSize (numChannels, maxJobSize * 2);
+
+    jobQueued = false;
+    jobDone = false;
+    clearOutput();
+
+    // Without a realtime worker the effects stay on the audio thread
+    if (! startRealtimeThread (juce::Thread::RealtimeOptions()))
+        return false;
+
+    running = true;
+    return true;
+}
+
+void FXPipeline::stop()
+{
+    if (! isThreadRunning())
+        return;
+
+    signalThreadShouldExit();
+    jobReady.release();
+    stopThread (1000);
+
+    running = false;
+    jobPending = false;
+}
+
+void FXPipeline::reset()
+{
+    if (! running)
+        return;
+
+    // A second means the worker is stuck, waiting any longer won't help
+    waitForJob (juce::Time::getHighResolutionTicks() + juce::Time::secondsToHighResolutionTicks (1.0));
+
+    clearOutput();
+}
+
+bool FXPipeline::waitForJob (juce::int64 deadlineTicks)
+{
+    if (! jobPending)
+        return true;
+
+    WT_TRACE_SCOPE ("waitForJob");
+
+    // The worker should take about as long as the effects did inline, so
+    // spin rather than sleep, an OS wakeup could cost more than the wait
+    while (! jobDone.load (std::memory_order_acquire))
+    {
+        if (juce::Time::getHighResolutionTicks() >= deadlineTicks)
+            return false;
+
+        std::this_thread::yield();
+    }
+
+    jobDone.store (false, std::memory_order_relaxed);
+    jobPending = false;
+    return true;
+}
+
+void FXPipeline::clearOutput()
+{
+    jassert (! jobPending);
+
+    output.clear();
+    output.writeSilence (latency);
+}
+
+void FXPipeline::exchange (juce::AudioSampleBuffer& block)
+{
+    jassert (! jobPending);
+
+    jobSize = block.getNumSamples();
+    jassert (jobSize <= job.getNumSamples());
+
+    for (int ch = 0; ch < job.getNumChannels(); ch++)
+        job.copyFrom (ch, 0, block, ch, 0, jobSize);
+
+    // Exactly the latency is waiting here unless a job was lost to a
+    // timeout, in which case put it back
+    auto ready = output.getNumReady();
+    if (ready > latency)
+        output.pop (ready - latency);
+    else if (ready < latency)
+        output.writeSilence (latency - ready);
+
+    output.read (block);
+}
+
+void FXPipeline::startJob()
+{
+    jobPending = true;
+    jobQueued.store (true, std::memory_order_release);
+    jobReady.release();
+}
+
+void FXPipeline::run()
+{
+    while (! threadShouldExit())
+    {
+        jobReady.acquire();
+
+        // Woken to exit, or by a release left over from a previous run
+        if (threadShouldExit() || ! jobQueued.exchange (false, std::memory_order_acquire))
+            continue;
+
+        auto slice = gin::sliceBuffer (job, 0, jobSize);
+
+        if (onProcess)
+            onProcess (slice);
+
+        output.write (slice);
+
+        jobDone.store (true, std::memory_order_release);
+    }
+}
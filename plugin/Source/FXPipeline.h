@@ -0,0 +1,71 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <semaphore>
+
+//==============================================================================
+/** Runs the effects a block behind the voices on a realtime worker thread, so
+    rendering block N overlaps with the effects of block N - 1.
+
+    The audio thread hands over each rendered block with exchange() and gets
+    back the processed audio from one job earlier. The output fifo starts with
+    a job's worth of silence, which is the latency reported to the host.
+    Between waitForJob() and startJob() the worker is idle, so that is where
+    the audio thread can touch effect state.
+
+    Nothing on the audio thread locks: jobs are handed over with a semaphore
+    and their completion is polled, up to a deadline.
+*/
+class FXPipeline : private juce::Thread
+{
+public:
+    FXPipeline();
+    ~FXPipeline() override;
+
+    /** Called on the worker with each job's audio, processed in place */
+    std::function<void (juce::AudioSampleBuffer&)> onProcess;
+
+    /** False if the worker couldn't be started, the effects have to run inline */
+    bool start (int numChannels, int maxJobSize);
+    void stop();
+
+    bool isRunning() const                  { return running; }
+    int getLatencySamples() const           { return running ? latency : 0; }
+
+    /** Waits for the job in flight and refills the output with silence. Not
+        for the audio thread, it waits as long as the worker takes. */
+    void reset();
+
+    //==============================================================================
+    // Audio thread
+    /** Waits for the job in flight until the deadline, in high resolution
+        ticks. False if it's still running, it stays in flight. */
+    bool waitForJob (juce::int64 deadlineTicks);
+
+    /** Drops whatever is queued for output and refills it with silence. The
+        worker must be idle. */
+    void clearOutput();
+
+    /** Takes a rendered block as the next job and replaces it with the
+        processed audio one job earlier. The worker must be idle. */
+    void exchange (juce::AudioSampleBuffer& block);
+
+    void startJob();
+
+private:
+    void run() override;
+
+    std::counting_semaphore<> jobReady { 0 };
+    std::atomic<bool> jobQueued { false }, jobDone { false };
+
+    juce::AudioSampleBuffer job;
+    int jobSize = 0;
+    bool jobPending = false;
+
+    gin::AudioFifo output;
+
+    int latency = 0;
+    std::atomic<bool> running { false };
+
+    JUCE_DECLARE_NON_COPYABLE (FXPipeline)
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Times how long the editor takes to paint. Call begin() at the start of the
+    top level paint() and end() at the end of paintOverChildren(), which covers
+    everything painted in between for that frame.
+*/
+class FrameTimer
+{
+public:
+    void begin()
+    {
+        start = juce::Time::getHighResolutionTicks();
+    }
+
+    void end()
+    {
+        if (start == 0)
+            return;
+
+        auto ms = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start) * 1000.0;
+        start = 0;
+
+        frames++;
+        totalMs += ms;
+        worstMs = std::max (worstMs, ms);
+    }
+
+    /** Average and worst since the last call, then starts counting again */
+    juce::String getReportAndReset()
+    {
+        auto text = frames > 0 ? juce::String::formatted ("%d frames, %.2fms avg, %.2fms worst", frames, totalMs / frames, worstMs)
+                               : juce::String ("No frames");
+
+        frames = 0;
+        totalMs = worstMs = 0.0;
+        return text;
+    }
+
+private:
+    juce::int64 start = 0;
+    int frames = 0;
+    double totalMs = 0.0, worstMs = 0.0;
+};
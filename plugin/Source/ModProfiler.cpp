@@ -0,0 +1,105 @@
+#include "ModProfiler.h"
+
+//==============================================================================
+static double ticksToUs (juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6;
+}
+
+double ModProfiler::Report::getModUsPerBlock() const
+{
+    double total = 0.0;
+    for (auto us : usPerBlock)
+        total += us;
+    return total;
+}
+
+double ModProfiler::Report::getModShare() const
+{
+    return blockUsPerBlock > 0.0 ? getModUsPerBlock() / blockUsPerBlock : 0.0;
+}
+
+juce::String ModProfiler::Report::toString() const
+{
+    return juce::String::formatted ("Routes: %d (%d mono, %d poly)\n"
+                                    "Evals/block: %.1f mono, %.1f poly\n"
+                                    "Params: %.1fus mono, %.1fus voice, finishBlock: %.1fus\n"
+                                    "Mod: %.1fus of %.1fus per block (%.0f%%)",
+                                    getActiveRoutes(), monoRoutes, polyRoutes,
+                                    monoEvalsPerBlock, polyEvalsPerBlock,
+                                    usPerBlock[monoParams], usPerBlock[voiceParams], usPerBlock[finishBlock],
+                                    getModUsPerBlock(), blockUsPerBlock, getModShare() * 100.0);
+}
+
+//==============================================================================
+void ModProfiler::setEnabled (bool e)
+{
+    if (e != enabled.load())
+    {
+        resetStats();
+        enabled = e;
+    }
+}
+
+void ModProfiler::setRoutes (int mono, int poly)
+{
+    monoRoutes = mono;
+    polyRoutes = poly;
+}
+
+void ModProfiler::resetStats()
+{
+    blocks = 0;
+    monoEvals = 0;
+    polyEvals = 0;
+    blockTicks = 0;
+
+    for (auto& t : sectionTicks)
+        t = 0;
+}
+
+ModProfiler::Report ModProfiler::getReport() const
+{
+    Report r;
+    r.monoRoutes = monoRoutes.load();
+    r.polyRoutes = polyRoutes.load();
+    r.blocks     = int (blocks.load());
+
+    if (r.blocks > 0)
+    {
+        auto n = double (r.blocks);
+
+        r.monoEvalsPerBlock = double (monoEvals.load()) / n;
+        r.polyEvalsPerBlock = double (polyEvals.load()) / n;
+        r.blockUsPerBlock   = ticksToUs (blockTicks.load()) / n;
+
+        for (int i = 0; i < numSections; i++)
+            r.usPerBlock[i] = ticksToUs (sectionTicks[i].load()) / n;
+    }
+
+    return r;
+}
+
+//==============================================================================
+void ModProfiler::addBlock (juce::int64 ticks)
+{
+    blocks.fetch_add (1, std::memory_order_relaxed);
+    blockTicks.fetch_add (ticks, std::memory_order_relaxed);
+}
+
+void ModProfiler::addMonoSlice()
+{
+    if (isEnabled())
+        monoEvals.fetch_add (monoRoutes.load (std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void ModProfiler::addPolySlice()
+{
+    if (isEnabled())
+        polyEvals.fetch_add (polyRoutes.load (std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void ModProfiler::addTime (Section s, juce::int64 ticks)
+{
+    sectionTicks[s].fetch_add (ticks, std::memory_order_relaxed);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Measures what the mod matrix costs for the current preset.
+
+    The audio thread adds evaluation counts and timings while profiling is
+    enabled, the UI or benchmark reads them back as a Report. Route counts are
+    updated whenever the matrix changes. When disabled every call is a single
+    relaxed load.
+*/
+class ModProfiler
+{
+public:
+    enum Section
+    {
+        monoParams,     // processor updateParams, mono getValue() calls
+        voiceParams,    // voice updateParams, poly getValue() calls
+        finishBlock,    // ModMatrix::finishBlock
+        numSections
+    };
+
+    struct Report
+    {
+        int monoRoutes = 0, polyRoutes = 0;
+        int blocks = 0;
+
+        double monoEvalsPerBlock = 0.0;
+        double polyEvalsPerBlock = 0.0;
+
+        double usPerBlock[numSections] = {};
+        double blockUsPerBlock = 0.0;
+
+        int getActiveRoutes() const                 { return monoRoutes + polyRoutes; }
+        double getModUsPerBlock() const;
+        double getModShare() const;
+
+        juce::String toString() const;
+    };
+
+    //==============================================================================
+    void setEnabled (bool e);
+    bool isEnabled() const                          { return enabled.load (std::memory_order_relaxed); }
+
+    void setRoutes (int mono, int poly);
+
+    /** Clears the accumulated counts and timings */
+    void resetStats();
+
+    Report getReport() const;
+
+    //==============================================================================
+    // Audio thread
+    void addBlock (juce::int64 ticks);
+    void addMonoSlice();
+    void addPolySlice();
+    void addTime (Section s, juce::int64 ticks);
+
+    /** Times a scope into one section, only when profiling is enabled */
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer (ModProfiler& p, Section s)
+            : profiler (p), section (s), start (p.isEnabled() ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            if (start != 0)
+                profiler.addTime (section, juce::Time::getHighResolutionTicks() - start);
+        }
+
+    private:
+        ModProfiler& profiler;
+        Section section;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTimer)
+    };
+
+private:
+    std::atomic<bool> enabled { false };
+    std::atomic<int> monoRoutes { 0 }, polyRoutes { 0 };
+
+    std::atomic<juce::int64> blocks { 0 }, monoEvals { 0 }, polyEvals { 0 }, blockTicks { 0 };
+    std::atomic<juce::int64> sectionTicks[numSections] = {};
+
+    JUCE_DECLARE_NON_COPYABLE (ModProfiler)
+};
@@ -0,0 +1,185 @@
+#include "Oversampler.h"
+
+//==============================================================================
+static double besselI0 (double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+HalfBandStage::HalfBandStage (int numTaps_)
+    : numTaps (numTaps_)
+{
+    jassert (numTaps % 2 == 0);
+
+    // Kaiser windowed sinc, about 80 dB down in the stop band. Only the odd
+    // offsets from the centre are kept, they form the FIR branch.
+    const double beta = 8.0;
+    const double halfLength = numTaps;
+    double sum = 0.0;
+
+    for (int i = 0; i < numTaps; i++)
+    {
+        auto m = double (2 * i - (numTaps - 1));
+        auto r = m / halfLength;
+        auto w = besselI0 (beta * std::sqrt (1.0 - r * r)) / besselI0 (beta);
+        auto h = std::sin (juce::MathConstants<double>::halfPi * m) / (juce::MathConstants<double>::pi * m) * w;
+
+        taps.push_back (float (h));
+        sum += h;
+    }
+
+    // The delay branch is 0.5, so the FIR branch is too at DC
+    for (auto& t : taps)
+        t = float (t * 0.5 / sum);
+}
+
+void HalfBandStage::prepare (int numChannels, int maxInputSamples)
+{
+    upHistory.setSize (numChannels, numTaps - 1 + maxInputSamples);
+    evenHistory.setSize (numChannels, numTaps - 1 + maxInputSamples);
+    oddHistory.setSize (numChannels, numTaps / 2 + maxInputSamples);
+    scratch.setSize (1, maxInputSamples);
+
+    reset();
+}
+
+void HalfBandStage::reset()
+{
+    upHistory.clear();
+    evenHistory.clear();
+    oddHistory.clear();
+}
+
+void HalfBandStage::upsample (int ch, const float* in, float* out, int numIn)
+{
+    const int historySize = numTaps - 1;
+
+    auto h = upHistory.getWritePointer (ch);
+    auto fir = scratch.getWritePointer (0);
+
+    juce::FloatVectorOperations::copy (h + historySize, in, numIn);
+
+    // Zero stuffing halves the level, the taps are doubled to make it up
+    juce::FloatVectorOperations::multiply (fir, h + historySize, 2.0f * taps[0], numIn);
+    for (int i = 1; i < numTaps; i++)
+        juce::FloatVectorOperations::addWithMultiply (fir, h + historySize - i, 2.0f * taps[size_t (i)], numIn);
+
+    auto delayed = h + numTaps / 2;
+    for (int i = 0; i < numIn; i++)
+    {
+        out[2 * i]     = fir[i];
+        out[2 * i + 1] = delayed[i];
+    }
+
+    std::memmove (h, h + numIn, size_t (historySize) * sizeof (float));
+}
+
+void HalfBandStage::downsample (int ch, const float* in, float* out, int numOut)
+{
+    const int evenSize = numTaps - 1;
+    const int oddSize = numTaps / 2;
+
+    auto e = evenHistory.getWritePointer (ch);
+    auto o = oddHistory.getWritePointer (ch);
+
+    for (int i = 0; i < numOut; i++)
+    {
+        e[evenSize + i] = in[2 * i];
+        o[oddSize + i]  = in[2 * i + 1];
+    }
+
+    juce::FloatVectorOperations::multiply (out, o, 0.5f, numOut);
+    for (int i = 0; i < numTaps; i++)
+        juce::FloatVectorOperations::addWithMultiply (out, e + evenSize - i, taps[size_t (i)], numOut);
+
+    std::memmove (e, e + numOut, size_t (evenSize) * sizeof (float));
+    std::memmove (o, o + numOut, size_t (oddSize) * sizeof (float));
+}
+
+//==============================================================================
+void HalfBandOversampler::prepare (int numChannels_, int maxBlockSize_)
+{
+    numChannels = numChannels_;
+    maxBlockSize = maxBlockSize_;
+
+    stage2x.prepare (numChannels, maxBlockSize);
+    stage4x.prepare (numChannels, maxBlockSize * 2);
+
+    buffer2x.setSize (numChannels, maxBlockSize * 2);
+    buffer4x.setSize (numChannels, maxBlockSize * 4);
+
+    compensation.assign (size_t (numChannels), 0.0f);
+}
+
+void HalfBandOversampler::reset()
+{
+    stage2x.reset();
+    stage4x.reset();
+
+    std::fill (compensation.begin(), compensation.end(), 0.0f);
+}
+
+void HalfBandOversampler::setNumStages (int n)
+{
+    n = juce::jlimit (0, 2, n);
+    if (n != numStages)
+    {
+        numStages = n;
+        reset();
+    }
+}
+
+int HalfBandOversampler::getLatencySamples (int stages) const
+{
+    if (stages == 1)
+        return stage2x.getLatency() / 2;
+    if (stages == 2)
+        return (stage2x.getLatency() + stage4x.getLatency() / 2 + 1) / 2;
+    return 0;
+}
+
+juce::AudioSampleBuffer HalfBandOversampler::processUp (juce::AudioSampleBuffer& buffer)
+{
+    auto n = buffer.getNumSamples();
+    auto channels = std::min (numChannels, buffer.getNumChannels());
+
+    jassert (numStages > 0 && n <= maxBlockSize);
+
+    for (int ch = 0; ch < channels; ch++)
+        stage2x.upsample (ch, buffer.getReadPointer (ch), buffer2x.getWritePointer (ch), n);
+
+    if (numStages == 1)
+        return gin::sliceBuffer (buffer2x, 0, n * 2);
+
+    for (int ch = 0; ch < channels; ch++)
+        stage4x.upsample (ch, buffer2x.getReadPointer (ch), buffer4x.getWritePointer (ch), n * 2);
+
+    return gin::sliceBuffer (buffer4x, 0, n * 4);
+}
+
+void HalfBandOversampler::processDown (juce::AudioSampleBuffer& buffer)
+{
+    auto n = buffer.getNumSamples();
+    auto channels = std::min (numChannels, buffer.getNumChannels());
+
+    for (int ch = 0; ch < channels; ch++)
+    {
+        if (numStages == 2)
+        {
+            auto d = buffer2x.getWritePointer (ch);
+            stage4x.downsample (ch, buffer4x.getReadPointer (ch), d, n * 2);
+
+            auto& last = compensation[size_t (ch)];
+            for (int i = 0; i < n * 2; i++)
+                std::swap (d[i], last);
+        }
+
+        stage2x.downsample (ch, buffer2x.getReadPointer (ch), buffer.getWritePointer (ch), n);
+    }
+}
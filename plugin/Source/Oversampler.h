@@ -0,0 +1,88 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** One 2x step of the oversampler: a linear phase half-band FIR split into its
+    two polyphase branches.
+
+    Every other tap of a half-band filter is zero apart from the centre one, so
+    one branch is a short symmetric FIR and the other is a plain delay, and both
+    run at the lower rate. The FIR branch is worked out a tap at a time across
+    the whole block so it runs on the vector ops.
+*/
+class HalfBandStage
+{
+public:
+    /** numTaps is the length of the FIR branch, the full filter is
+        2 * numTaps - 1 taps long */
+    explicit HalfBandStage (int numTaps);
+
+    void prepare (int numChannels, int maxInputSamples);
+    void reset();
+
+    /** Delay of an up and a down pass together, in samples at the higher rate */
+    int getLatency() const                  { return 2 * (numTaps - 1); }
+
+    /** Writes 2 * numIn samples */
+    void upsample (int ch, const float* in, float* out, int numIn);
+
+    /** Reads 2 * numOut samples */
+    void downsample (int ch, const float* in, float* out, int numOut);
+
+private:
+    const int numTaps;
+    std::vector<float> taps;
+
+    // Each holds the history the filter needs followed by the current block
+    juce::AudioSampleBuffer upHistory, evenHistory, oddHistory;
+    juce::AudioSampleBuffer scratch;
+
+    JUCE_DECLARE_NON_COPYABLE (HalfBandStage)
+};
+
+//==============================================================================
+/** Runs a nonlinear effect at 2x or 4x the sample rate so its harmonics above
+    Nyquist are filtered out instead of folding back down.
+
+    Call processUp() with a block, process the buffer it returns, then call
+    processDown() with the original block to write the result back. Blocks
+    must not be longer than the size given to prepare().
+*/
+class HalfBandOversampler
+{
+public:
+    HalfBandOversampler() = default;
+
+    void prepare (int numChannels, int maxBlockSize);
+    void reset();
+
+    /** 0 is off, 1 is 2x and 2 is 4x. Resets the filters when it changes. */
+    void setNumStages (int n);
+    int getNumStages() const                { return numStages; }
+    int getFactor() const                   { return 1 << numStages; }
+
+    int getMaxBlockSize() const             { return maxBlockSize; }
+
+    /** The delay added by the filters, in samples at the base rate */
+    int getLatencySamples() const           { return getLatencySamples (numStages); }
+    int getLatencySamples (int stages) const;
+
+    juce::AudioSampleBuffer processUp (juce::AudioSampleBuffer& buffer);
+    void processDown (juce::AudioSampleBuffer& buffer);
+
+private:
+    // The second stage only has to keep out what the first let through, so it
+    // can be much shorter
+    HalfBandStage stage2x { 32 }, stage4x { 16 };
+
+    juce::AudioSampleBuffer buffer2x, buffer4x;
+
+    // The 4x stage's delay is an odd number of 2x samples, one more makes the
+    // total a whole number of base rate samples
+    std::vector<float> compensation;
+
+    int numStages = 0, numChannels = 0, maxBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (HalfBandOversampler)
+};
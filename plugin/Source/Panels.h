@@ -2,6 +2,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "WavetableDisplay.h"
 #include "Cfg.h"
 
 //==============================================================================
@@ -39,9 +40,9 @@ public:
 
         watchParam (osc.voices);
 
-        wt = new gin::WavetableComponent();
+        wt = new WavetableDisplay();
         wt->setName ("wt");
-        wt->setWavetables (idx == 0 ? &proc.osc1Tables : &proc.osc2Tables);
+        updateWavetable();
         wt->onFileDrop = [this] (const juce::File& f) { loadUserWavetable (f); };
         wt->addMouseListener (this, false);
         addControl (wt);
@@ -66,6 +67,11 @@ public:
         timer.startTimerHz (60);
         timer.onTimer = [this]
         {
+            WT_TRACE_SCOPE ("OscillatorBox timer");
+
+            if (proc.getWavetablePreviewVersion (idx) != previewVersion)
+                updateWavetable();
+
             wt->setParams (proc.getLiveWTParams (idx));
         };
 
@@ -143,16 +149,46 @@ public:
         }
         else if (e.originalComponent == &h && e.mouseWasClicked() && e.x >= prevButton.getRight() && e.x <= nextButton.getX())
         {
-            auto files = proc.getWavetableFiles();
+            // Built from the index in memory, it keeps scanning in the background
+            auto index = proc.wavetableIndex->getSnapshot();
+
+            auto current = idx == 0 ? proc.osc1Table.toString() : proc.osc2Table.toString();
+            auto currentIsUser = (idx == 0 ? proc.userTable1 : proc.userTable2).getSize() > 0;
+            auto thumbColour = findColour (gin::PluginLookAndFeel::accentColourId, true);
 
-            std::map<juce::String, juce::PopupMenu> menus;
+            std::map<juce::String, juce::PopupMenu> menus, userMenus;
+            std::vector<juce::PopupMenu::Item> userTop;
 
-            for (auto& f : files)
+            for (auto& e : index->entries)
             {
-                auto t = f.getFileNameWithoutExtension();
-                auto category = f.getParentDirectory().getFileName();
+                if (e.analysed && e.tableSize <= 0)
+                    continue;
+
+                juce::PopupMenu::Item item (e.name);
+                item.isTicked = e.name == current && e.user == currentIsUser;
+
+                if (e.analysed)
+                {
+                    auto d = std::make_unique<juce::DrawablePath>();
+                    d->setPath (WavetableIndex::createThumbnailPath (e, { 0.0f, 0.0f, 32.0f, 16.0f }));
+                    d->setFill (juce::Colours::transparentBlack);
+                    d->setStrokeFill (thumbColour);
+                    d->setStrokeType (juce::PathStrokeType (1.0f));
+                    item.image = std::move (d);
+                }
+
+                if (e.user)
+                {
+                    item.action = [this, f = e.file] { loadUserWavetable (f); };
+                    if (e.category.isEmpty())
+                        userTop.push_back (std::move (item));
+                    else
+                        userMenus[e.category].addItem (std::move (item));
+                    continue;
+                }
 
-                menus[category].addItem (t, [this, t]
+                auto t = e.name;
+                item.action = [this, t]
                 {
                     if (idx == 0)
                     {
@@ -166,7 +202,8 @@ public:
                     }
 
                     proc.reloadWavetables();
-                });
+                };
+                menus[e.category].addItem (std::move (item));
             }
 
             juce::PopupMenu m;
@@ -175,7 +212,30 @@ public:
             for (auto itr : menus)
                 m.addSubMenu (itr.first, itr.second);
 
+            if (! userMenus.empty() || ! userTop.empty())
+            {
+                juce::PopupMenu user;
+                for (auto itr : userMenus)
+                    user.addSubMenu (itr.first, itr.second);
+
+                // Tables straight in the user folder, after its subfolders
+                if (! userMenus.empty() && ! userTop.empty())
+                    user.addSeparator();
+
+                for (auto& item : userTop)
+                    user.addItem (std::move (item));
+
+                m.addSeparator();
+                m.addSubMenu ("User", user);
+            }
+
+            if (! index->complete)
+                m.addItem ("Scanning...", false, false, [] {});
+
             m.showMenuAsync ({});
+
+            // Picks up tables added since, for next time
+            proc.wavetableIndex->rescan();
         }
     }
 
@@ -191,7 +251,13 @@ public:
     void valueChanged (juce::Value&) override
     {
         setTitle (idx == 0 ? proc.osc1Table.toString() : proc.osc2Table.toString());
-        wt->setWavetables (idx == 0 ? &proc.osc1Tables : &proc.osc2Tables);
+        updateWavetable();
+    }
+
+    void updateWavetable()
+    {
+        previewVersion = proc.getWavetablePreviewVersion (idx);
+        wt->setPreview (proc.getWavetablePreview (idx));
     }
 
     void paramChanged() override
@@ -207,7 +273,8 @@ public:
     WavetableAudioProcessor& proc;
     int idx = 0;
     gin::ParamComponent::Ptr detune, spread;
-    gin::WavetableComponent* wt;
+    WavetableDisplay* wt;
+    int previewVersion = -1;
     float mouseDownValue;
 
     gin::CoalescedTimer timer;
@@ -606,9 +673,37 @@ public:
         addHeader ({"SRC", "MTX"}, 1, proc.uiParams.activeMOD);
 
         addControl (new gin::ModMatrixBox (proc, proc.modMatrix), 0, 0, 3, 2);
+
+        // Mod matrix cost, only shown while profiling is enabled
+        addChildComponent (profile);
+        profile.setInterceptsMouseClicks (false, false);
+        profile.setJustificationType (juce::Justification::bottomLeft);
+        profile.setFont (juce::Font (9.0f));
+
+        timer.startTimerHz (2);
+        timer.onTimer = [this]
+        {
+            WT_TRACE_SCOPE ("MatrixBox timer");
+
+            auto enabled = proc.modProfiler.isEnabled();
+            if (enabled)
+                profile.setText (proc.modProfiler.getReport().toString(), juce::dontSendNotification);
+
+            profile.setVisible (enabled);
+        };
+    }
+
+    void resized() override
+    {
+        gin::ParamBox::resized();
+
+        profile.setBounds (getLocalBounds().removeFromBottom (48).reduced (4, 2));
     }
 
     WavetableAudioProcessor& proc;
+
+    juce::Label profile;
+    gin::CoalescedTimer timer;
 };
 
 //==============================================================================
@@ -782,6 +877,19 @@ public:
                 proc.fxParams.distMode->setUserValue (3.0f);
             });
 
+            juce::PopupMenu os;
+            os.setLookAndFeel (&getLookAndFeel());
+
+            auto oversample = proc.fxParams.distOversample->getUserValueInt();
+            auto setOversample = [this] (int i) { proc.fxParams.distOversample->setUserValue (float (i)); };
+
+            os.addItem ("Off", true, oversample == 0, [setOversample] { setOversample (0); });
+            os.addItem ("2x",  true, oversample == 1, [setOversample] { setOversample (1); });
+            os.addItem ("4x",  true, oversample == 2, [setOversample] { setOversample (2); });
+
+            m.addSeparator();
+            m.addSubMenu ("Oversampling", os);
+
             m.showMenuAsync ({});
         };
 
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Linear smoothing for the mod matrix destinations, done outside the matrix so
+    a destination that has reached its target costs a compare and nothing more.
+
+    Entries are indexed by the parameters' mod index. Call advance() once at the
+    start of each slice, then process() for every value read during it. A value
+    read several times in one slice only moves on the first read.
+*/
+class LinearParamSmoothers
+{
+public:
+    /** Allocates the entries, false ones pass their values straight through */
+    void setup (const std::vector<bool>& smoothed)
+    {
+        entries.assign (smoothed.size(), {});
+
+        for (size_t i = 0; i < smoothed.size(); i++)
+            entries[i].smoothed = smoothed[i];
+    }
+
+    void setSampleRate (double sr)          { sampleRate = sr; updateRamp(); }
+    void setTime (float t)                  { time = t; updateRamp(); }
+
+    /** The next value of every entry is taken without smoothing */
+    void reset()
+    {
+        for (auto& e : entries)
+            e.valid = false;
+    }
+
+    void advance (int numSamples)
+    {
+        blockSize = numSamples;
+        block++;
+    }
+
+    float process (int index, float target)
+    {
+        if (index < 0 || index >= int (entries.size()))
+            return target;
+
+        auto& e = entries[size_t (index)];
+        if (! e.smoothed)
+            return target;
+
+        if (! e.valid)
+            return snap (e, target);
+
+        if (target != e.target)
+        {
+            e.target = target;
+            e.remaining = rampSamples;
+            e.step = (target - e.current) / float (rampSamples);
+        }
+
+        if (e.remaining == 0)
+            return e.target;
+
+        if (e.block != block)
+        {
+            e.block = block;
+
+            auto n = std::min (blockSize, e.remaining);
+            e.remaining -= n;
+            e.current = e.remaining == 0 ? e.target : e.current + e.step * float (n);
+        }
+        return e.current;
+    }
+
+    /** Jumps straight to the value, e.g. while a voice is starting */
+    float snap (int index, float value)
+    {
+        if (index < 0 || index >= int (entries.size()))
+            return value;
+
+        return snap (entries[size_t (index)], value);
+    }
+
+private:
+    struct Entry
+    {
+        float current = 0.0f, target = 0.0f, step = 0.0f;
+        int remaining = 0;
+        uint32_t block = 0;
+        bool smoothed = false, valid = false;
+    };
+
+    float snap (Entry& e, float value)
+    {
+        e.current = e.target = value;
+        e.remaining = 0;
+        e.block = block;
+        e.valid = true;
+        return value;
+    }
+
+    void updateRamp()                       { rampSamples = std::max (1, juce::roundToInt (time * sampleRate)); }
+
+    std::vector<Entry> entries;
+
+    double sampleRate = 44100.0;
+    float time = 0.02f;
+    int rampSamples = 882, blockSize = 0;
+    uint32_t block = 0;
+};
@@ -8,12 +8,14 @@ WavetableAudioProcessorEditor::WavetableAudioProcessorEditor (WavetableAudioProc
     scope.setName ("scope");
     scope.setNumChannels (2);
     scope.setTriggerMode (gin::TriggeredScope::TriggerMode::Up);
+    scope.setNumSamplesPerPixel (2.0f);
     scope.setColour (gin::TriggeredScope::traceColourId + 0, findColour(gin::PluginLookAndFeel::accentColourId, true).withAlpha (0.7f));
     scope.setColour (gin::TriggeredScope::traceColourId + 1, findColour(gin::PluginLookAndFeel::accentColourId, true).withAlpha (0.7f));
     scope.setColour (gin::TriggeredScope::lineColourId, juce::Colours::transparentBlack);
 
     addAndMakeVisible (editor);
     addAndMakeVisible (scope);
+    wtProc.scopeFeed.setActive (true);
     
     usage.panic.onClick = [this]
     {
@@ -28,11 +30,62 @@ WavetableAudioProcessorEditor::WavetableAudioProcessorEditor (WavetableAudioProc
     modOverview.setBounds (usage.getRight() + 10, 12, 150, 16);
     scope.setBounds (704, 5, 187, 30);
 
+    addChildComponent (frameTime);
+    frameTime.setInterceptsMouseClicks (false, false);
+    frameTime.setJustificationType (juce::Justification::centredRight);
+    frameTime.setFont (juce::Font (9.0f));
+    frameTime.setBounds (scope.getX() - 310, 6, 300, 14);
+
+    addChildComponent (dropouts);
+    dropouts.setInterceptsMouseClicks (false, false);
+    dropouts.setJustificationType (juce::Justification::centredRight);
+    dropouts.setFont (juce::Font (9.0f));
+    dropouts.setColour (juce::Label::textColourId, juce::Colours::orange);
+    dropouts.setBounds (scope.getX() - 310, 20, 300, 14);
+
+    dropoutTimer.onTimer = [this] { updateDropouts(); };
+    dropoutTimer.startTimerHz (2);
+
+    frameTimeTimer.onTimer = [this]
+    {
+        WT_TRACE_SCOPE ("frameTime timer");
+
+        auto changes = editor.getParamChangeCount();
+        auto layouts = editor.getLayoutUpdateCount();
+
+        frameTime.setText (frameTimer.getReportAndReset()
+                           + juce::String::formatted (", %d changes in %d layouts", changes - lastParamChanges, layouts - lastLayoutUpdates),
+                           juce::dontSendNotification);
+
+        lastParamChanges = changes;
+        lastLayoutUpdates = layouts;
+    };
+
     setSize (943, 671);
 }
 
 WavetableAudioProcessorEditor::~WavetableAudioProcessorEditor()
 {
+    wtProc.scopeFeed.setActive (false);
+}
+
+void WavetableAudioProcessorEditor::updateDropouts()
+{
+    WT_TRACE_SCOPE ("dropouts timer");
+
+    auto s = wtProc.getDropoutStats();
+
+    if (s.missedBlocks == 0 && s.overDeadline == 0)
+    {
+        dropouts.setVisible (false);
+        return;
+    }
+
+    auto text = juce::String::formatted ("%d missed, %d cut off, %d late, worst %.1fms", int (s.missedBlocks), int (s.voiceKills), int (s.overDeadline), s.worstRenderMs);
+    text << ", last " << juce::Time (s.lastDropoutTime).toString (false, true, true, true);
+
+    dropouts.setText (text, juce::dontSendNotification);
+    dropouts.setVisible (true);
 }
 
 //==============================================================================
@@ -55,6 +108,9 @@ void WavetableAudioProcessorEditor::showAboutInfo()
 
 void WavetableAudioProcessorEditor::paint (juce::Graphics& g)
 {
+    if (showFrameTime)
+        frameTimer.begin();
+
     ProcessorEditor::paint (g);
 
     if (titleBar != nullptr)
@@ -63,6 +119,14 @@ void WavetableAudioProcessorEditor::paint (juce::Graphics& g)
     g.fillAll (findColour (gin::PluginLookAndFeel::blackColourId));
 }
 
+void WavetableAudioProcessorEditor::paintOverChildren (juce::Graphics& g)
+{
+    ProcessorEditor::paintOverChildren (g);
+
+    if (showFrameTime)
+        frameTimer.end();
+}
+
 void WavetableAudioProcessorEditor::resized()
 {
     ProcessorEditor::resized ();
@@ -86,6 +150,72 @@ void WavetableAudioProcessorEditor::addMenuItems (juce::PopupMenu& m)
 			props->setValue ("mpe", wtProc.globalParams.mpe->getUserValueBool());
     });
 
+    auto setFXQuality = [this] (int quality)
+    {
+        wtProc.globalParams.fxQuality->setUserValue (float (quality));
+
+        if (auto props = wtProc.getSettings())
+            props->setValue ("fxQuality", quality);
+    };
+
+    const auto quality = wtProc.globalParams.fxQuality->getUserValueInt();
+
+    juce::PopupMenu qm;
+    qm.addItem ("Double", true, quality == 0, [setFXQuality] { setFXQuality (0); });
+    qm.addItem ("Float",  true, quality == 1, [setFXQuality] { setFXQuality (1); });
+    qm.addItem ("Auto (Float Live, Double Offline)", true, quality == 2, [setFXQuality] { setFXQuality (2); });
+
+    m.addSubMenu ("FX Precision", qm);
+
+    m.addItem ("Run FX on Separate Thread", true, wtProc.isFXThreadEnabled(), [this]
+    {
+        wtProc.setFXThreadEnabled (! wtProc.isFXThreadEnabled());
+
+        if (auto props = wtProc.getSettings())
+            props->setValue ("fxThread", wtProc.isFXThreadEnabled());
+    });
+
+    m.addItem ("Profile Modulation", true, wtProc.modProfiler.isEnabled(), [this]
+    {
+        wtProc.modProfiler.setEnabled (! wtProc.modProfiler.isEnabled());
+    });
+
+   #if WT_TRACING
+    m.addItem ("Record Trace", true, Trace::isRecording(), []
+    {
+        if (Trace::isRecording())
+        {
+            Trace::stop();
+            Trace::getFile().revealToUser();
+        }
+        else
+        {
+            auto dir = juce::File::getSpecialLocation (juce::File::userDocumentsDirectory).getChildFile ("Wavetable Traces");
+            Trace::start (dir.getChildFile (juce::Time::getCurrentTime().formatted ("trace-%Y%m%d-%H%M%S.json")));
+        }
+    });
+   #endif
+
+    m.addItem ("Reset Dropout Counters", true, false, [this]
+    {
+        wtProc.resetDropoutStats();
+        updateDropouts();
+    });
+
+    m.addItem ("Show Frame Time", true, showFrameTime, [this]
+    {
+        showFrameTime = ! showFrameTime;
+        frameTime.setVisible (showFrameTime);
+        frameTimer.getReportAndReset();
+        lastParamChanges = editor.getParamChangeCount();
+        lastLayoutUpdates = editor.getLayoutUpdateCount();
+
+        if (showFrameTime)
+            frameTimeTimer.startTimerHz (2);
+        else
+            frameTimeTimer.stopTimer();
+    });
+
     auto setSize = [this] (float scale)
     {
         if (auto p = findParentComponentOfClass<gin::ScaledPluginEditor>())
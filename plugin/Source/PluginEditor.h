@@ -4,6 +4,7 @@
 #include "PluginProcessor.h"
 #include "Panels.h"
 #include "Editor.h"
+#include "FrameTimer.h"
 
 //==============================================================================
 class WavetableAudioProcessorEditor : public gin::ProcessorEditor,
@@ -15,6 +16,7 @@ public:
 
     //==============================================================================
     void paint (juce::Graphics&) override;
+    void paintOverChildren (juce::Graphics&) override;
     void resized() override;
     void addMenuItems (juce::PopupMenu& m) override;
 
@@ -23,13 +25,25 @@ public:
 private:
     WavetableAudioProcessor& wtProc;
 
-    gin::TriggeredScope scope { wtProc.scopeFifo };
+    gin::TriggeredScope scope { wtProc.scopeFeed.getFifo() };
     gin::SynthesiserUsage usage { wtProc };
     gin::ModulationOverview modOverview { wtProc.modMatrix };
     gin::ModOverlay modOverlay;
 
     Editor editor { wtProc };
 
+    // Paint time, only measured and shown when turned on from the menu
+    FrameTimer frameTimer;
+    bool showFrameTime = false;
+    juce::Label frameTime;
+    gin::CoalescedTimer frameTimeTimer;
+    int lastParamChanges = 0, lastLayoutUpdates = 0;
+
+    // Only shown once something has gone wrong
+    juce::Label dropouts;
+    gin::CoalescedTimer dropoutTimer;
+    void updateDropouts();
+
    #if JUCE_DEBUG
     std::unique_ptr<melatonin::Inspector> inspector;
    #endif
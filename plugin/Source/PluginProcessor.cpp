@@ -86,6 +86,32 @@ static juce::String enableTextFunction (const gin::Parameter&, float v)
     return v > 0.0f ? "On" : "Off";
 }
 
+static juce::String fxQualityTextFunction (const gin::Parameter&, float v)
+{
+    switch (int (v))
+    {
+        case 0: return "Double";
+        case 1: return "Float";
+        case 2: return "Auto";
+        default:
+            jassertfalse;
+            return {};
+    }
+}
+
+static juce::String oversampleTextFunction (const gin::Parameter&, float v)
+{
+    switch (int (v))
+    {
+        case 0: return "Off";
+        case 1: return "2x";
+        case 2: return "4x";
+        default:
+            jassertfalse;
+            return {};
+    }
+}
+
 static juce::String durationTextFunction (const gin::Parameter&, float v)
 {
     return gin::NoteDuration::getNoteDurations()[size_t (v)].getName();
@@ -320,11 +346,15 @@ void WavetableAudioProcessor::GlobalParams::setup (WavetableAudioProcessor& p)
     voices      = p.addIntParam ("voices",      "Voices",     "",         "",   { 2.0, 40.0, 1.0, 1.0 }, 40.0f, 0.0f);
     mpe         = p.addIntParam ("mpe",         "MPE",        "",         "",   { 0.0, 1.0, 1.0, 1.0 }, 0.0f, 0.0f, enableTextFunction);
     pitchBend   = p.addIntParam ("pitchbend",   "Pitch Bend", "PB Range", "",   { 0.0, 48.0, 1.0, 1.0 }, 2.0f, 0.0f);
+    fxQuality   = p.addIntParam ("fxQuality",   "FX Quality", "",         "",   { 0.0, 2.0, 1.0, 1.0 }, 0.0f, 0.0f, fxQualityTextFunction);
 
     level->conversionFunction     = [] (float in) { return juce::Decibels::decibelsToGain (in); };
 
 	if (auto props = p.getSettings())
+	{
 		mpe->setUserValue (props->getBoolValue ("mpe", false) ? 1.0f : 0.0f);
+		fxQuality->setUserValue (float (props->getIntValue ("fxQuality", 0)));
+	}
 }
 
 //==============================================================================
@@ -370,8 +400,6 @@ void WavetableAudioProcessor::DelayParams::setup (WavetableAudioProcessor& p)
     cf    = p.addExtParam ("dlCf",    "CF",        "", "dB", {-100.0f,   0.0f, 0.0f, 5.0f}, -100.0f, 0.0f);
     mix   = p.addExtParam ("dlMix",   "Mix",       "", "%",  {   0.0f, 100.0f, 0.0f, 1.0f},    0.5f, 0.0f);
 
-    delay = p.addIntParam ("dlDelay", "Delay",     "", "",   {   0.0f, 120.0f, 0.0f, 1.0f},    1.0f, 0.0f);
-
     fb->conversionFunction  = [] (float in) { return juce::Decibels::decibelsToGain (in); };
     cf->conversionFunction  = [] (float in) { return juce::Decibels::decibelsToGain (in); };
     mix->conversionFunction = [] (float in) { return in / 100.0f; };
@@ -399,6 +427,7 @@ void WavetableAudioProcessor::FXParams::setup (WavetableAudioProcessor& p)
     fx4         = p.addIntParam ("fxOrder4",   "FX4",       "",   "", { 0.0, 4.0, 1.0, 1.0 }, fxDelay,   0.0f);
     fx5         = p.addIntParam ("fxOrder5",   "FX5",       "",   "", { 0.0, 4.0, 1.0, 1.0 }, fxReverb,  0.0f);
     distMode    = p.addIntParam ("distMode",   "Dist Mode", "",   "", { 0.0, 3.0, 1.0, 1.0 }, 0,  0.0f);
+    distOversample = p.addIntParam ("distOversample", "Dist Oversample", "", "", { 0.0, 2.0, 1.0, 1.0 }, 0, 0.0f, oversampleTextFunction);
 }
 
 //==============================================================================
@@ -588,6 +617,18 @@ WavetableAudioProcessor::WavetableAudioProcessor()
 {
     launchCrashReporterOnce();
 
+    fxPipeline.onProcess = [this] (juce::AudioSampleBuffer& buffer)
+    {
+        applyEffects (buffer, jobSnapshots, 0, jobNumSnapshots);
+    };
+
+    if (auto props = getSettings())
+        fxThreadEnabled = props->getBoolValue ("fxThread", false);
+
+    wavetableIndex->scan (systemResourceRoot().getChildFile ("Wavetables"),
+                          userResourceRoot().getChildFile ("Wavetables"),
+                          userResourceRoot().getChildFile ("WavetableIndex.cache"));
+
     // One-time migration of any user presets from the pre-installer location.
     // Factory presets now live in systemResourceRoot()/Presets and are surfaced
     // via getFactoryProgramDirectories(). User saves go to userResourceRoot()/Presets.
@@ -643,16 +684,21 @@ WavetableAudioProcessor::WavetableAudioProcessor()
     fireAmpParams.setup (*this);
     grindAmpParams.setup (*this);
 
-    for (int i = 0; i < 50; i++)
+    for (int i = 0; i < Cfg::numVoices; i++)
     {
         auto voice = new WavetableVoice (*this);
         modMatrix.addVoice (voice);
         addVoice (voice);
+        wavetableVoices.push_back (voice);
     }
 
     setupModMatrix();
+    modMatrix.addListener (this);
     init();
 
+    for (auto p : getEffectChainParams())
+        p->addListener (this);
+
     lastMono = globalParams.mono->isOn();
 
 	reset();
@@ -660,6 +706,14 @@ WavetableAudioProcessor::WavetableAudioProcessor()
 
 WavetableAudioProcessor::~WavetableAudioProcessor()
 {
+    cancelPendingUpdate();
+    fxPipeline.stop();
+
+    modMatrix.removeListener (this);
+
+    for (auto p : getEffectChainParams())
+        p->removeListener (this);
+
 	MTS_DeregisterClient (mtsClient);
 	mtsClient = nullptr;
 }
@@ -699,23 +753,23 @@ void WavetableAudioProcessor::reloadWavetables()
     if (userTable1.getSize() > 0)
     {
         if (shouldLoad (0, osc1Table.toString(), sr))
-            loadWaveTable (osc1Tables, sr, userTable1, "wav", osc1Size);
+            loadWaveTable (0, sr, userTable1, "wav", osc1Size);
     }
     else if (auto mb = loadMemory (osc1Table.toString()); mb.getSize() > 0)
     {
         if (shouldLoad (0, osc1Table.toString(), sr))
-            loadWaveTable (osc1Tables, sr, mb, "flac", osc1Size);
+            loadWaveTable (0, sr, mb, "flac", osc1Size);
     }
 
     if (userTable2.getSize() > 0)
     {
         if (shouldLoad (1, osc2Table.toString(), sr))
-            loadWaveTable (osc2Tables, sr, userTable2, "wav", osc2Size);
+            loadWaveTable (1, sr, userTable2, "wav", osc2Size);
     }
     else if (auto mb = loadMemory (osc2Table.toString()); mb.getSize() > 0)
     {
         if (shouldLoad (1, osc2Table.toString(), sr))
-            loadWaveTable (osc2Tables, sr, mb, "flac", osc2Size);
+            loadWaveTable (1, sr, mb, "flac", osc2Size);
     }
 }
 
@@ -743,7 +797,6 @@ void WavetableAudioProcessor::incWavetable (int osc, int delta)
 
 bool WavetableAudioProcessor::loadUserWavetable (int osc, const juce::File& f, int sz)
 {
-    auto& table = osc == 0 ? osc1Tables : osc2Tables;
     auto& mb    = osc == 0 ? userTable1 : userTable2;
     auto& name  = osc == 0 ? osc1Table  : osc2Table;
     auto& size  = osc == 0 ? osc1Size   : osc2Size;
@@ -751,7 +804,7 @@ bool WavetableAudioProcessor::loadUserWavetable (int osc, const juce::File& f, i
     juce::MemoryBlock raw;
     f.loadFileAsData (raw);
 
-    if (loadWaveTable (table, gin::Processor::getSampleRate(), raw, "wav", sz))
+    if (loadWaveTable (osc, gin::Processor::getSampleRate(), raw, "wav", sz))
     {
         mb = raw;
         name = f.getFileNameWithoutExtension();
@@ -764,6 +817,8 @@ bool WavetableAudioProcessor::loadUserWavetable (int osc, const juce::File& f, i
 //==============================================================================
 void WavetableAudioProcessor::stateUpdated()
 {
+    WT_TRACE_SCOPE ("stateUpdated");
+
     modMatrix.stateUpdated (state);
 
     osc1Table = state.getProperty ("wt1");
@@ -781,6 +836,10 @@ void WavetableAudioProcessor::stateUpdated()
     reloadWavetables();
     presetLoaded = true;
     lastMono = globalParams.mono->isOn();
+    effectChainDirty = true;
+    triggerAsyncUpdate();
+
+    modMatrixChanged();
 }
 
 void WavetableAudioProcessor::updateState()
@@ -816,8 +875,19 @@ juce::Array<juce::File> WavetableAudioProcessor::getFactoryProgramDirectories()
 juce::StringArray WavetableAudioProcessor::getWavetableNames() const
 {
     juce::StringArray tables;
-    for (auto& f : getWavetableFiles())
-        tables.add (f.getFileNameWithoutExtension());
+
+    // The index has them in memory once its first scan is done
+    if (auto index = wavetableIndex->getSnapshot(); index->complete)
+    {
+        for (auto& e : index->entries)
+            if (! e.user)
+                tables.add (e.name);
+    }
+    else
+    {
+        for (auto& f : getWavetableFiles())
+            tables.add (f.getFileNameWithoutExtension());
+    }
 
     tables.sortNatural();
     return tables;
@@ -889,11 +959,64 @@ void WavetableAudioProcessor::setupModMatrix()
         if (pp == firstMonoParam)
             polyParam = false;
 
-        if (! pp->isInternal() || pp == delayParams.delay)
-            modMatrix.addParameter (pp, polyParam, getSmoothingTime (pp));
+        if (! pp->isInternal())
+        {
+            // The matrix doesn't smooth, see getSmoothingPolicy()
+            modMatrix.addParameter (pp, polyParam, 0.0f);
+
+            if (polyParam)
+                polyModDsts.add (pp->getModIndex());
+        }
     }
 
     modMatrix.build();
+
+    for (auto pp : getPluginParameters())
+    {
+        if (pp->isInternal())
+            continue;
+
+        auto idx = size_t (pp->getModIndex());
+        if (idx >= linearSmoothed.size())
+            linearSmoothed.resize (idx + 1, false);
+
+        linearSmoothed[idx] = getSmoothingPolicy (pp) == Smoothing::linear;
+    }
+
+    monoSmoothers.setup (linearSmoothed);
+    for (auto v : wavetableVoices)
+        v->smoothers.setup (linearSmoothed);
+
+    modMatrixChanged();
+}
+
+void WavetableAudioProcessor::modMatrixChanged()
+{
+    // Routes to poly params are evaluated once per active voice
+    int monoRoutes = 0, polyRoutes = 0;
+    for (int i = 0; i < modMatrix.getNumModSources(); i++)
+        for (auto& d : modMatrix.getModDepths (gin::ModSrcId (i)))
+            (polyModDsts.contains (d.first.id) ? polyRoutes : monoRoutes)++;
+
+    modProfiler.setRoutes (monoRoutes, polyRoutes);
+}
+
+void WavetableAudioProcessor::updateRetuneTable (bool force, int numSamples)
+{
+    // The master can retune at any time without telling us, so while one is
+    // connected the table is also refreshed every so often
+    bool hasMaster = MTS_HasMaster (mtsClient);
+
+    retuneSamplesLeft -= numSamples;
+
+    if (! force && hasMaster == mtsHadMaster && (! hasMaster || retuneSamplesLeft > 0))
+        return;
+
+    mtsHadMaster = hasMaster;
+    retuneSamplesLeft = int (getSampleRate() * 0.05);
+
+    for (int i = 0; i < 128; i++)
+        retuneTable[size_t (i)] = float (MTS_RetuningInSemitones (mtsClient, char (i), -1));
 }
 
 bool WavetableAudioProcessor::isParamLocked (gin::Parameter* p)
@@ -905,15 +1028,32 @@ bool WavetableAudioProcessor::isParamLocked (gin::Parameter* p)
     return false;
 }
 
-float WavetableAudioProcessor::getSmoothingTime (gin::Parameter*)
+WavetableAudioProcessor::Smoothing WavetableAudioProcessor::getSmoothingPolicy (gin::Parameter* p)
 {
-    return 0.02f;
+    if (p == globalParams.level || p == chorusParams.mix || p == delayParams.mix || p == reverbParams.mix
+        || p == delayParams.time)
+        return Smoothing::eased;
+
+    // Waveforms, types, switches, note values etc. have nothing to glide through.
+    // Levels and tunings step by 1 but are still continuous.
+    if (p->isInternal() || p == delayParams.sync || p == delayParams.beat)
+        return Smoothing::none;
+
+    return Smoothing::linear;
+}
+
+float WavetableAudioProcessor::getMonoValue (gin::Parameter* p)
+{
+    return monoSmoothers.process (p->getModIndex(), modMatrix.getValue (p));
 }
 
 void WavetableAudioProcessor::reset()
 {
     Processor::reset();
 
+    // Lets the job in flight finish before its effects are reset
+    fxPipeline.reset();
+
     gate.reset();
     chorus.reset();
     stereoDelay.reset();
@@ -921,6 +1061,21 @@ void WavetableAudioProcessor::reset()
 	bitcrusher.reset();
 	fireAmp.reset();
 	grindAmp.reset();
+    distOversampler.reset();
+    oversamplerFlush = 0;
+
+    // The Airwindows effects reset their parameters too
+    invalidateEffectParams();
+
+    for (auto s : { &chorusSleeper, &delaySleeper, &reverbSleeper })
+        s->reset();
+
+    for (auto s : { &levelSmoother, &chorusMixSmoother, &delayMixSmoother, &reverbMixSmoother, &delayTimeSmoother })
+        s->reset();
+
+    outputGainValid = false;
+
+    monoSmoothers.reset();
 
     for (auto& l : modLFOs)
         l.reset();
@@ -934,6 +1089,9 @@ void WavetableAudioProcessor::prepareToPlay (double newSampleRate, int newSample
 {
     Processor::prepareToPlay (newSampleRate, newSamplesPerBlock);
 
+    fxPipeline.stop();
+    fxThreadActive = false;
+
     setCurrentPlaybackSampleRate (newSampleRate);
 
     modMatrix.setSampleRate (newSampleRate);
@@ -943,6 +1101,38 @@ void WavetableAudioProcessor::prepareToPlay (double newSampleRate, int newSample
     stereoDelay.setSampleRate (newSampleRate);
     reverb.setSampleRate (float (newSampleRate));
 
+    // Enough slices for a whole host buffer, longer buffers run the effects in batches
+    fxSnapshots.resize (size_t (std::max (1, (newSamplesPerBlock + 31) / 32)));
+    jobSnapshots.resize (fxSnapshots.size());
+
+    // If the worker doesn't start the effects run inline
+    fxJobSize = int (fxSnapshots.size()) * 32;
+    if (fxThreadEnabled)
+        fxPipeline.start (2, fxJobSize);
+
+    // Sets the distortion modes' sample rates
+    distOversampler.prepare (2, newSamplesPerBlock);
+    scopeFeed.prepare (newSampleRate, newSamplesPerBlock);
+    updateEffectChain();
+    updateLatency();
+
+    invalidateEffectParams();
+
+    for (auto s : { &chorusSleeper, &delaySleeper, &reverbSleeper })
+        s->setSampleRate (newSampleRate);
+
+    chorusSleeper.setHoldTime (0.1);
+    reverbSleeper.setHoldTime (0.35);
+
+    for (auto s : { &levelSmoother, &chorusMixSmoother, &delayMixSmoother, &reverbMixSmoother, &delayTimeSmoother })
+    {
+        s->setSampleRate (newSampleRate);
+        s->setTime (0.02f);
+    }
+
+    monoSmoothers.setSampleRate (newSampleRate);
+    monoSmoothers.setTime (0.02f);
+
     for (auto& l : modLFOs)
         l.setSampleRate (newSampleRate);
 
@@ -952,8 +1142,20 @@ void WavetableAudioProcessor::prepareToPlay (double newSampleRate, int newSample
     analogTables.setSampleRate (newSampleRate);
 }
 
+void WavetableAudioProcessor::invalidateEffectParams()
+{
+    chorusCache.invalidate();
+    bitcrusherCache.invalidate();
+    fireAmpCache.invalidate();
+    grindAmpCache.invalidate();
+    delayCache.invalidate();
+    reverbCache.invalidate();
+}
+
 void WavetableAudioProcessor::releaseResources()
 {
+    fxPipeline.stop();
+    fxThreadActive = false;
 }
 
 bool WavetableAudioProcessor::isBusesLayoutSupported (const BusesLayout& layout) const
@@ -967,38 +1169,109 @@ bool WavetableAudioProcessor::isBusesLayoutSupported (const BusesLayout& layout)
 void WavetableAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
 {
     juce::ScopedNoDenormals noDenormals;
+    WT_TRACE_SCOPE ("processBlock");
 
     if (buffer.getNumChannels() != 2)
         return;
 
+    const auto blockStart = juce::Time::getHighResolutionTicks();
+
     if (! dspLock.tryEnter())
     {
+        WT_TRACE_INSTANT ("blockMissed");
+        buffer.clear();
         blockMissed = true;
+        missedBlocks.fetch_add (1, std::memory_order_relaxed);
+        noteDropout();
         return;
     }
 
+    // Offline renders can wait for the FX thread as long as it takes
+    blockDeadline = isNonRealtime() || getSampleRate() <= 0
+                      ? std::numeric_limits<juce::int64>::max()
+                      : blockStart + juce::Time::secondsToHighResolutionTicks (buffer.getNumSamples() / getSampleRate());
+
+    updateFXThread();
+
     if (midiLearn)
         midiLearn->processBlock (midi, buffer.getNumSamples());
 
 	if (mtsClient)
+	{
+		bool sysex = false;
 		for (auto itr : midi)
-			if (auto m = itr.getMessage(); m.isSysEx())
+		{
+			if (itr.numBytes > 0 && itr.data[0] == 0xf0)
+			{
 				MTS_ParseMIDIDataU (mtsClient, itr.data, itr.numBytes);
+				sysex = true;
+			}
+		}
+
+		updateRetuneTable (sysex, buffer.getNumSamples());
+	}
 
     if (blockMissed || presetLoaded || lastMono != globalParams.mono->isOn())
     {
+        if (blockMissed && std::any_of (voices.begin(), voices.end(), [] (auto v) { return v->isActive(); }))
+        {
+            WT_TRACE_INSTANT ("voiceKill");
+            voiceKills.fetch_add (1, std::memory_order_relaxed);
+            noteDropout();
+        }
+
         blockMissed = presetLoaded = false;
         lastMono = globalParams.mono->isOn();
-        stereoDelay.reset();
-        reverb.reset();
+        resetEffectTails = true;
         turnOffAllVoices (false);
     }
 
+    totalBlocks.fetch_add (1, std::memory_order_relaxed);
+
+    // Nothing playing, nothing ringing out and nothing arriving, the output is
+    // silence so skip the mod matrix, voices and effects entirely. Not with
+    // the FX thread, a block of output is still to come out of it. The
+    // oversampling filters still hold the last few samples, so blocks keep
+    // being rendered until a latency's worth of silence has pushed them out.
+    const bool quiet = ! fxThreadActive && isIdle (midi);
+
+    if (! quiet)
+        oversamplerFlush = distOversampler.getLatencySamples();
+    else if (oversamplerFlush > 0)
+        oversamplerFlush -= buffer.getNumSamples();
+    else
+    {
+        idleBlocks.fetch_add (1, std::memory_order_relaxed);
+
+        buffer.clear();
+        startBlock();
+        publishTelemetry();
+        endBlock (buffer.getNumSamples());
+
+        finishBlockTiming (blockStart, buffer.getNumSamples());
+        dspLock.exit();
+        return;
+    }
+
+    const auto profileStart = modProfiler.isEnabled() ? juce::Time::getHighResolutionTicks() : 0;
+
     startBlock();
     setMPE (globalParams.mpe->isOn());
     setPitchBendRange (globalParams.pitchBend->getUserValueInt());
 
-    playhead = getPlayHead();
+    // Auto keeps the distortion state in float while live and in double for offline renders
+    const auto fxQuality = globalParams.fxQuality->getUserValueInt();
+    fxDoublePrecision = fxQuality == 0 || (fxQuality == 2 && isNonRealtime());
+
+    if (auto hostPlayHead = getPlayHead())
+    {
+        blockPlayHead.position = hostPlayHead->getPosition();
+        playhead = &blockPlayHead;
+    }
+    else
+    {
+        playhead = nullptr;
+    }
 
     int pos = 0;
     int todo = buffer.getNumSamples();
@@ -1012,54 +1285,149 @@ void WavetableAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
     setGlideRate (globalParams.glideRate->getProcValue());
     setNumVoices (int (globalParams.voices->getProcValue()));
 
+    int fxPos = 0;
+    int numSnapshots = 0;
+
     while (todo > 0)
     {
         int thisBlock = std::min (todo, 32);
 
-        updateParams (thisBlock);
+        auto& snapshot = fxSnapshots[size_t (numSnapshots++)];
+
+        {
+            ModProfiler::ScopedTimer t (modProfiler, ModProfiler::monoParams);
+            modProfiler.addMonoSlice();
+            updateParams (thisBlock);
+            updateFXParams (snapshot, thisBlock);
+        }
 
         renderNextBlock (buffer, midi, pos, thisBlock);
 
-        auto bufferSlice = gin::sliceBuffer (buffer, pos, thisBlock);
-        applyEffects (bufferSlice);
+        snapshot.noteOnIndex  = noteOnIndex;
+        snapshot.noteOffIndex = noteOffIndex;
 
-        modMatrix.finishBlock (thisBlock);
+        {
+            ModProfiler::ScopedTimer t (modProfiler, ModProfiler::finishBlock);
+            modMatrix.finishBlock (thisBlock);
+        }
 
         pos += thisBlock;
         todo -= thisBlock;
+
+        if (todo == 0 || numSnapshots == int (fxSnapshots.size()))
+        {
+            processEffects (buffer, fxPos, pos - fxPos, numSnapshots);
+
+            fxPos = pos;
+            numSnapshots = 0;
+        }
     }
 
     playhead = nullptr;
 
-    if (buffer.getNumSamples() <= scopeFifo.getFreeSpace() && buffer.getNumChannels() == scopeFifo.getNumChannels())
-        scopeFifo.write (buffer);
+    scopeFeed.process (buffer);
 
+    publishTelemetry();
     endBlock (buffer.getNumSamples());
-       
+
+    if (profileStart != 0)
+        modProfiler.addBlock (juce::Time::getHighResolutionTicks() - profileStart);
+
+    finishBlockTiming (blockStart, buffer.getNumSamples());
     dspLock.exit();
 }
 
-juce::Array<float> WavetableAudioProcessor::getLiveFilterCutoff()
+bool WavetableAudioProcessor::isIdle (const juce::MidiBuffer& midi)
 {
-    juce::Array<float> values;
+    if (! midi.isEmpty())
+        return false;
 
     for (auto v : voices)
-    {
         if (v->isActive())
-        {
-            auto vav = dynamic_cast<WavetableVoice*>(v);
-            values.add (vav->getFilterCutoffNormalized());
-        }
+            return false;
+
+    // The gate and distortion have no tail
+    if (chorusParams.enable->isOn() && ! chorusSleeper.isAsleep())  return false;
+    if (delayParams.enable->isOn()  && ! delaySleeper.isAsleep())   return false;
+    if (reverbParams.enable->isOn() && ! reverbSleeper.isAsleep())  return false;
+
+    return true;
+}
+
+double WavetableAudioProcessor::getIdleRatio() const
+{
+    auto total = totalBlocks.load();
+    return total > 0 ? double (idleBlocks.load()) / double (total) : 0.0;
+}
+
+void WavetableAudioProcessor::finishBlockTiming (juce::int64 startTicks, int numSamples)
+{
+    auto ms = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+
+    if (ms > worstRenderMs.load (std::memory_order_relaxed))
+        worstRenderMs.store (ms, std::memory_order_relaxed);
+
+    // Offline renders can take as long as they like
+    auto sr = getSampleRate();
+    if (! isNonRealtime() && sr > 0 && ms > 1000.0 * numSamples / sr)
+    {
+        overDeadlineBlocks.fetch_add (1, std::memory_order_relaxed);
+        noteDropout();
     }
+}
+
+void WavetableAudioProcessor::noteDropout()
+{
+    lastDropoutTime.store (juce::Time::currentTimeMillis(), std::memory_order_relaxed);
+}
+
+WavetableAudioProcessor::DropoutStats WavetableAudioProcessor::getDropoutStats() const
+{
+    DropoutStats s;
+    s.blocks          = totalBlocks.load();
+    s.missedBlocks    = missedBlocks.load();
+    s.voiceKills      = voiceKills.load();
+    s.overDeadline    = overDeadlineBlocks.load();
+    s.worstRenderMs   = worstRenderMs.load();
+    s.lastDropoutTime = lastDropoutTime.load();
+    return s;
+}
+
+void WavetableAudioProcessor::resetDropoutStats()
+{
+    missedBlocks = 0;
+    voiceKills = 0;
+    overDeadlineBlocks = 0;
+    worstRenderMs = 0.0;
+    lastDropoutTime = 0;
+}
+
+void WavetableAudioProcessor::publishTelemetry()
+{
+    auto& frame = telemetry.getWriteBuffer();
+
+    for (size_t i = 0; i < wavetableVoices.size(); i++)
+        wavetableVoices[i]->getTelemetry (frame[i]);
+
+    telemetry.publish();
+}
+
+juce::Array<float> WavetableAudioProcessor::getLiveFilterCutoff()
+{
+    juce::Array<float> values;
+
+    for (auto& v : telemetry.read())
+        if (v.active)
+            values.add (v.cutoff);
+
     return values;
 }
 
 gin::WTOscillator::Params WavetableAudioProcessor::getLiveWTParams (int osc)
 {
-    for (auto v : voices)
-        if (v->isActive())
-            if (auto vav = dynamic_cast<WavetableVoice*>(v))
-                return vav->getLiveWTParams (osc);
+    for (auto& v : telemetry.read())
+        if (v.active)
+            return v.wt[osc];
 
     gin::WTOscillator::Params p;
     p.position  = oscParams[osc].pos->getUserValue() / 100.0f;
@@ -1068,67 +1436,474 @@ gin::WTOscillator::Params WavetableAudioProcessor::getLiveWTParams (int osc)
     return p;
 }
 
-void WavetableAudioProcessor::applyEffect (juce::AudioSampleBuffer& buffer, int fxId)
+bool WavetableAudioProcessor::FXSnapshot::sameGate (const FXSnapshot& other) const
+{
+    return gateFreq    == other.gateFreq
+        && gateAttack  == other.gateAttack
+        && gateRelease == other.gateRelease;
+}
+
+bool WavetableAudioProcessor::FXSnapshot::sameChorus (const FXSnapshot& other) const
 {
-    // Apply gate
-    if (fxId == fxGate && gateParams.enable->isOn())
-        gate.process (buffer, noteOnIndex, noteOffIndex);
+    return chorus == other.chorus;
+}
 
-    // Apply Chorus
-    if (fxId == fxChorus && chorusParams.enable->isOn())
-        chorus.process (buffer);
+bool WavetableAudioProcessor::FXSnapshot::sameDistortion (const FXSnapshot& other) const
+{
+    return distortion == other.distortion && amp == other.amp;
+}
 
-    // Apply Distortion
-    if (fxId == fxDistort && distortionParams.enable->isOn())
+bool WavetableAudioProcessor::FXSnapshot::sameDelay (const FXSnapshot& other) const
+{
+    return delay == other.delay;
+}
+
+bool WavetableAudioProcessor::FXSnapshot::sameReverb (const FXSnapshot& other) const
+{
+    return reverb == other.reverb;
+}
+
+juce::Array<gin::Parameter*> WavetableAudioProcessor::getEffectChainParams()
+{
+    return { fxParams.fx1, fxParams.fx2, fxParams.fx3, fxParams.fx4, fxParams.fx5, fxParams.distMode,
+             fxParams.distOversample, gateParams.enable, chorusParams.enable, distortionParams.enable, delayParams.enable,
+             delayParams.sync, reverbParams.enable };
+}
+
+void WavetableAudioProcessor::updateEffectChain()
+{
+    effectChainSize = 0;
+    distortionFn = nullptr;
+
+    // An effect listed more than once only runs in its first slot
+    uint32_t used = 0;
+
+    for (auto p : { fxParams.fx1, fxParams.fx2, fxParams.fx3, fxParams.fx4, fxParams.fx5 })
     {
-        auto mode = fxParams.distMode->getUserValueInt();
-        if (mode == 0)
+        auto fxId = p->getUserValueInt();
+        if (fxId < 0 || fxId >= int (effectChain.size()) || (used & (1u << fxId)) != 0)
+            continue;
+
+        used |= 1u << fxId;
+
+        EffectFn fn = nullptr;
+
+        if (fxId == fxGate && gateParams.enable->isOn())
         {
-            auto clip = 1.0f / (2.0f * distortionVal);
-            gin::Distortion::processBlock (buffer, distortionVal, -clip, clip);
+            fn = &WavetableAudioProcessor::processGate;
         }
-        else if (mode == 1)
+        else if (fxId == fxChorus && chorusParams.enable->isOn())
         {
-            bitcrusher.processReplacing ((float**)buffer.getArrayOfWritePointers(), (float**)buffer.getArrayOfWritePointers(), buffer.getNumSamples());
+            fn = &WavetableAudioProcessor::processChorus;
         }
-        else if (mode == 2)
+        else if (fxId == fxDistort)
+        {
+            if (distortionParams.enable->isOn())
+            {
+                auto mode = fxParams.distMode->getUserValueInt();
+                if (mode == 0)      distortionFn = &WavetableAudioProcessor::processDistortion;
+                else if (mode == 1) distortionFn = &WavetableAudioProcessor::processBitcrusher;
+                else if (mode == 2) distortionFn = &WavetableAudioProcessor::processFireAmp;
+                else if (mode == 3) distortionFn = &WavetableAudioProcessor::processGrindAmp;
+            }
+
+            // With oversampling on the slot runs through the filters even while
+            // the distortion is off, so the delay stays the same
+            if (distortionFn != nullptr || fxParams.distOversample->getUserValueInt() > 0)
+                fn = &WavetableAudioProcessor::processDistortionSlot;
+        }
+        else if (fxId == fxDelay && delayParams.enable->isOn())
         {
-            fireAmp.processReplacing ((float**)buffer.getArrayOfWritePointers(), (float**)buffer.getArrayOfWritePointers(), buffer.getNumSamples());
+            fn = delayParams.sync->isOn() ? &WavetableAudioProcessor::processDelay : &WavetableAudioProcessor::processDelaySmoothed;
         }
-        else if (mode == 3)
+        else if (fxId == fxReverb && reverbParams.enable->isOn())
+        {
+            fn = &WavetableAudioProcessor::processReverb;
+        }
+
+        if (fn != nullptr)
+            effectChain[size_t (effectChainSize++)] = fn;
+    }
+
+    // An FX order without the distortion still has to be delayed to match
+    if ((used & (1u << fxDistort)) == 0 && fxParams.distOversample->getUserValueInt() > 0)
+        effectChain[size_t (effectChainSize++)] = &WavetableAudioProcessor::processDistortionSlot;
+
+    distOversampler.setNumStages (fxParams.distOversample->getUserValueInt());
+
+    auto factor = distOversampler.getFactor();
+    bitcrusher.updateSampleRate (factor);
+    fireAmp.updateSampleRate (factor);
+    grindAmp.updateSampleRate (factor);
+}
+
+void WavetableAudioProcessor::updateLatency()
+{
+    // From the settings rather than the chain, so the distortion going on and
+    // off doesn't move the host's delay compensation
+    auto distLatency = distOversampler.getLatencySamples (fxParams.distOversample->getUserValueInt());
+    setLatencySamples (distLatency + (fxThreadEnabled ? fxPipeline.getLatencySamples() : 0));
+}
+
+void WavetableAudioProcessor::valueUpdated (gin::Parameter* p)
+{
+    effectChainDirty = true;
+
+    // Not from the audio thread, setLatencySamples() calls into the host
+    if (p == fxParams.distOversample)
+        triggerAsyncUpdate();
+}
+
+void WavetableAudioProcessor::handleAsyncUpdate()
+{
+    updateLatency();
+}
+
+void WavetableAudioProcessor::updateEffectState()
+{
+    if (resetEffectTails)
+    {
+        resetEffectTails = false;
+        stereoDelay.reset();
+        reverb.reset();
+    }
+
+    if (effectChainDirty.exchange (false))
+        updateEffectChain();
+
+    fireAmp.setDoublePrecision (fxDoublePrecision);
+    grindAmp.setDoublePrecision (fxDoublePrecision);
+}
+
+void WavetableAudioProcessor::setFXThreadEnabled (bool enabled)
+{
+    // Only once prepared, prepareToPlay starts it otherwise. Once up the
+    // worker stays up until prepareToPlay or releaseResources, the audio
+    // thread may still be using it, and idles when it isn't.
+    if (enabled && fxJobSize > 0 && ! fxPipeline.isRunning())
+        fxPipeline.start (2, fxJobSize);
+
+    fxThreadEnabled = enabled;
+
+    updateLatency();
+}
+
+void WavetableAudioProcessor::updateFXThread()
+{
+    auto wanted = fxThreadEnabled.load() && fxPipeline.isRunning();
+    if (wanted == fxThreadActive)
+        return;
+
+    // Not with a job in flight, the next block tries again. The audio it
+    // had queued for output is dropped either way.
+    if (! fxPipeline.waitForJob (blockDeadline))
+        return;
+
+    fxPipeline.clearOutput();
+    fxThreadActive = wanted;
+}
+
+/** Calls fn (slice, params) for each stretch of the slices an effect runs
+    with one set of parameters, which are the last slice's. A stretch ends where
+    the parameters change, but not before it's minParamRun samples long, so
+    modulation costs an effect that can't ramp a call per minParamRun rather
+    than one per slice. The gate also ends one before a second note on or off,
+    it can only take one of each per call. */
+template <typename Same, typename Fn>
+void WavetableAudioProcessor::forEachParamRun (juce::AudioSampleBuffer& buffer, std::span<const FXSnapshot> slices,
+                                               bool splitAtNotes, Same same, Fn fn)
+{
+    int pos = 0;
+
+    for (size_t i = 0; i < slices.size();)
+    {
+        auto run = slices[i++];
+
+        for (; i < slices.size(); i++)
         {
-            grindAmp.processReplacing ((float**)buffer.getArrayOfWritePointers(), (float**)buffer.getArrayOfWritePointers(), buffer.getNumSamples());
+            auto& next = slices[i];
+
+            if (! same (run, next) && run.numSamples >= minParamRun)
+                break;
+
+            if (splitAtNotes && ((next.noteOnIndex >= 0 && run.noteOnIndex >= 0)
+                                 || (next.noteOffIndex >= 0 && run.noteOffIndex >= 0)))
+                break;
+
+            auto numSamples = run.numSamples;
+            auto noteOn = run.noteOnIndex, noteOff = run.noteOffIndex;
+
+            run = next;
+            run.numSamples   = numSamples + next.numSamples;
+            run.noteOnIndex  = next.noteOnIndex >= 0 ? numSamples + next.noteOnIndex : noteOn;
+            run.noteOffIndex = next.noteOffIndex >= 0 ? numSamples + next.noteOffIndex : noteOff;
         }
+
+        auto slice = gin::sliceBuffer (buffer, pos, run.numSamples);
+        fn (slice, run);
+
+        pos += run.numSamples;
     }
+}
 
-    // Apply Delay
-    if (fxId == fxDelay && delayParams.enable->isOn())
+void WavetableAudioProcessor::processGate (juce::AudioSampleBuffer& buffer, std::span<const FXSnapshot> slices)
+{
+    forEachParamRun (buffer, slices, true, [] (auto& a, auto& b) { return a.sameGate (b); },
+                     [this] (juce::AudioSampleBuffer& slice, const FXSnapshot& s)
     {
-        if (delayParams.sync->isOn())
-            stereoDelay.process (buffer);
+        setGateParams (s);
+        gate.process (slice, s.noteOnIndex, s.noteOffIndex);
+    });
+}
+
+void WavetableAudioProcessor::processChorus (juce::AudioSampleBuffer& buffer, std::span<const FXSnapshot> slices)
+{
+    if (! chorusSleeper.shouldProcess (buffer))
+        return;
+
+    forEachParamRun (buffer, slices, false, [] (auto& a, auto& b) { return a.sameChorus (b); },
+                     [this] (juce::AudioSampleBuffer& slice, const FXSnapshot& s)
+    {
+        setChorusParams (s);
+        chorus.process (slice);
+    });
+
+    if (chorusSleeper.processed (buffer))
+        chorus.reset();
+}
+
+void WavetableAudioProcessor::processDistortion (juce::AudioSampleBuffer& buffer, const FXSnapshot& snapshot)
+{
+    auto clip = 1.0f / (2.0f * snapshot.distortion);
+    gin::Distortion::processBlock (buffer, snapshot.distortion, -clip, clip);
+}
+
+void WavetableAudioProcessor::processBitcrusher (juce::AudioSampleBuffer& buffer, const FXSnapshot&)
+{
+    bitcrusher.processReplacing ((float**)buffer.getArrayOfWritePointers(), (float**)buffer.getArrayOfWritePointers(), buffer.getNumSamples());
+}
+
+void WavetableAudioProcessor::processFireAmp (juce::AudioSampleBuffer& buffer, const FXSnapshot&)
+{
+    fireAmp.processReplacing ((float**)buffer.getArrayOfWritePointers(), (float**)buffer.getArrayOfWritePointers(), buffer.getNumSamples());
+}
+
+void WavetableAudioProcessor::processGrindAmp (juce::AudioSampleBuffer& buffer, const FXSnapshot&)
+{
+    grindAmp.processReplacing ((float**)buffer.getArrayOfWritePointers(), (float**)buffer.getArrayOfWritePointers(), buffer.getNumSamples());
+}
+
+void WavetableAudioProcessor::processDistortionSlot (juce::AudioSampleBuffer& buffer, std::span<const FXSnapshot> slices)
+{
+    forEachParamRun (buffer, slices, false, [] (auto& a, auto& b) { return a.sameDistortion (b); },
+                     [this] (juce::AudioSampleBuffer& run, const FXSnapshot& s)
+    {
+        if (distortionFn != nullptr)
+            setDistortionParams (s);
+
+        if (distOversampler.getFactor() == 1)
+        {
+            (this->*distortionFn) (run, s);
+            return;
+        }
+
+        const int maxBlock = distOversampler.getMaxBlockSize();
+
+        for (int pos = 0; pos < run.getNumSamples(); pos += maxBlock)
+        {
+            auto slice = gin::sliceBuffer (run, pos, std::min (maxBlock, run.getNumSamples() - pos));
+
+            auto oversampled = distOversampler.processUp (slice);
+            if (distortionFn != nullptr)
+                (this->*distortionFn) (oversampled, s);
+            distOversampler.processDown (slice);
+        }
+    });
+}
+
+void WavetableAudioProcessor::processDelay (juce::AudioSampleBuffer& buffer, std::span<const FXSnapshot> slices)
+{
+    if (! delaySleeper.shouldProcess (buffer))
+        return;
+
+    // A synced time jumps with the tempo, so this one can't ramp
+    forEachParamRun (buffer, slices, false, [] (auto& a, auto& b) { return a.sameDelay (b); },
+                     [this] (juce::AudioSampleBuffer& slice, const FXSnapshot& s)
+    {
+        setDelayParams (s);
+        stereoDelay.process (slice);
+    });
+
+    if (delaySleeper.processed (buffer))
+        stereoDelay.reset();
+}
+
+void WavetableAudioProcessor::processDelaySmoothed (juce::AudioSampleBuffer& buffer, std::span<const FXSnapshot> slices)
+{
+    if (! delaySleeper.shouldProcess (buffer))
+        return;
+
+    // The delay glides to the batch's last values itself, sample by sample
+    setDelayParams (slices.back());
+    stereoDelay.processSmoothed (buffer);
+
+    if (delaySleeper.processed (buffer))
+        stereoDelay.reset();
+}
+
+void WavetableAudioProcessor::processReverb (juce::AudioSampleBuffer& buffer, std::span<const FXSnapshot> slices)
+{
+    if (! reverbSleeper.shouldProcess (buffer))
+        return;
+
+    forEachParamRun (buffer, slices, false, [] (auto& a, auto& b) { return a.sameReverb (b); },
+                     [this] (juce::AudioSampleBuffer& slice, const FXSnapshot& s)
+    {
+        setReverbParams (s);
+        reverb.process (slice.getWritePointer (0), slice.getWritePointer (1), slice.getNumSamples ());
+    });
+
+    if (reverbSleeper.processed (buffer))
+        reverb.reset();
+}
+
+void WavetableAudioProcessor::processEffects (juce::AudioSampleBuffer& buffer, int startSample, int numSamples, int numSnapshots)
+{
+    WT_TRACE_SCOPE ("processEffects");
+
+    if (! fxThreadActive)
+    {
+        updateEffectState();
+        applyEffects (buffer, fxSnapshots, startSample, numSnapshots);
+        return;
+    }
+
+    auto slice = gin::sliceBuffer (buffer, startSample, numSamples);
+
+    if (! fxPipeline.waitForJob (blockDeadline))
+    {
+        // The worker would make the block late, output silence rather than
+        // hold up the audio thread. The job stays in flight for the next one.
+        slice.clear();
+        return;
+    }
+
+    // The worker is idle until the next job starts. The snapshots go with the
+    // audio, the next block's are written into the previous job's.
+    fxPipeline.exchange (slice);
+    std::swap (fxSnapshots, jobSnapshots);
+    jobNumSnapshots = numSnapshots;
+
+    updateEffectState();
+    fxPipeline.startJob();
+}
+
+void WavetableAudioProcessor::applyEffects (juce::AudioSampleBuffer& buffer, const std::vector<FXSnapshot>& snapshots, int startSample, int numSnapshots)
+{
+    WT_TRACE_SCOPE ("applyEffects");
+
+    if (numSnapshots <= 0)
+        return;
+
+    // Each effect takes the whole batch in one call and splits it only where
+    // its own parameters need to change, see forEachParamRun()
+    std::span<const FXSnapshot> slices (snapshots.data(), size_t (numSnapshots));
+
+    int numSamples = 0;
+    for (auto& s : slices)
+        numSamples += s.numSamples;
+
+    auto batch = gin::sliceBuffer (buffer, startSample, numSamples);
+
+    for (int fx = 0; fx < effectChainSize; fx++)
+        (this->*effectChain[size_t (fx)]) (batch, slices);
+
+    // Output gain, a linear ramp between the slices' values
+    if (! outputGainValid)
+    {
+        outputGain = slices[0].gain;
+        outputGainValid = true;
+    }
+
+    int pos = 0;
+    for (auto& s : slices)
+    {
+        if (s.gain == outputGain)
+            batch.applyGain (pos, s.numSamples, s.gain);
         else
-            stereoDelay.processSmoothed (buffer);
+            batch.applyGainRamp (pos, s.numSamples, outputGain, s.gain);
+
+        outputGain = s.gain;
+        pos += s.numSamples;
     }
+}
+
+void WavetableAudioProcessor::setGateParams (const FXSnapshot& s)
+{
+    int n = int (gateParams.length->getProcValue());
+
+    gate.setLength (n);
+
+    for (int i = 0; i < n; i++)
+        gate.setStep (i, gateParams.l[i]->isOn(), gateParams.r[i]->isOn());
 
-    // Apply Reverb
-    if (fxId == fxReverb && reverbParams.enable->isOn())
-        reverb.process (buffer.getWritePointer (0), buffer.getWritePointer (1), buffer.getNumSamples ());
+    gate.setFrequency (s.gateFreq);
+    gate.setAttack (s.gateAttack);
+    gate.setRelease (s.gateRelease);
 }
 
-void WavetableAudioProcessor::applyEffects (juce::AudioSampleBuffer& buffer)
+void WavetableAudioProcessor::setChorusParams (const FXSnapshot& s)
 {
-    applyEffect (buffer, fxParams.fx1->getUserValueInt());
-    applyEffect (buffer, fxParams.fx2->getUserValueInt());
-    applyEffect (buffer, fxParams.fx3->getUserValueInt());
-    applyEffect (buffer, fxParams.fx4->getUserValueInt());
-    applyEffect (buffer, fxParams.fx5->getUserValueInt());
+    if (chorusCache.update (s.chorus))
+        chorus.setParams (s.chorus[0], s.chorus[1], s.chorus[2], s.chorus[3], s.chorus[4]);
+}
 
-    // Output gain
-    outputGain.process (buffer);
+void WavetableAudioProcessor::setDistortionParams (const FXSnapshot& s)
+{
+    auto update = [&] (FXBase& fx, EffectParamCache<4>& cache)
+    {
+        if (cache.update (s.amp))
+            for (int i = 0; i < 4; i++)
+                fx.setParameter (i, s.amp[size_t (i)]);
+    };
+
+    auto mode = fxParams.distMode->getUserValueInt();
+    if (mode == 1)
+        update (bitcrusher, bitcrusherCache);
+    else if (mode == 2)
+        update (fireAmp, fireAmpCache);
+    else if (mode == 3)
+        update (grindAmp, grindAmpCache);
+}
+
+void WavetableAudioProcessor::setDelayParams (const FXSnapshot& s)
+{
+    if (delayCache.update (s.delay))
+    {
+        stereoDelay.setParams (s.delay[0], s.delay[1], s.delay[2], s.delay[3]);
+
+        // Silence between echoes can last as long as the delay time
+        delaySleeper.setHoldTime (s.delay[0] + 0.25);
+    }
+}
+
+void WavetableAudioProcessor::setReverbParams (const FXSnapshot& s)
+{
+    if (reverbCache.update (s.reverb))
+    {
+        reverb.setSize (s.reverb[0]);
+        reverb.setDecay (s.reverb[1]);
+        reverb.setLowpass (s.reverb[2]);
+        reverb.setDamping (s.reverb[3]);
+        reverb.setPredelay (s.reverb[4]);
+        reverb.setMix (s.reverb[5]);
+    }
 }
 
 void WavetableAudioProcessor::updateParams (int newBlockSize)
 {
+    monoSmoothers.advance (newBlockSize);
+
     // Update Mono LFOs
     for (int i = 0; i < Cfg::numLFOs; i++)
     {
@@ -1140,13 +1915,13 @@ void WavetableAudioProcessor::updateParams (int newBlockSize)
             if (lfoParams[i].sync->getProcValue() > 0.0f)
                 freq = 1.0f / gin::NoteDuration::getNoteDurations()[size_t (lfoParams[i].beat->getProcValue())].toSeconds (playhead);
             else
-                freq = modMatrix.getValue (lfoParams[i].rate);
+                freq = getMonoValue (lfoParams[i].rate);
 
             params.waveShape = (gin::LFO::WaveShape) int (lfoParams[i].wave->getProcValue());
             params.frequency = freq;
-            params.phase     = modMatrix.getValue (lfoParams[i].phase);
-            params.offset    = modMatrix.getValue (lfoParams[i].offset);
-            params.depth     = modMatrix.getValue (lfoParams[i].depth);
+            params.phase     = getMonoValue (lfoParams[i].phase);
+            params.offset    = getMonoValue (lfoParams[i].offset);
+            params.depth     = getMonoValue (lfoParams[i].depth);
             params.delay     = 0;
             params.fade      = 0;
 
@@ -1181,104 +1956,94 @@ void WavetableAudioProcessor::updateParams (int newBlockSize)
     {
         modMatrix.setMonoValue (modSrcMonoStep, 0);
     }
+}
 
-    // Update Gate
+void WavetableAudioProcessor::updateFXParams (FXSnapshot& s, int newBlockSize)
+{
+    s = {};
+    s.numSamples = newBlockSize;
+
+    // Gate
     if (gateParams.enable->isOn())
     {
-        float freq = 1.0f / gin::NoteDuration::getNoteDurations()[size_t (gateParams.beat->getProcValue())].toSeconds (playhead);
-
-        int n = int (gateParams.length->getProcValue());
-
-        gate.setLength (n);
-
-        for (int i = 0; i < n; i++)
-            gate.setStep (i, gateParams.l[i]->isOn(), gateParams.r[i]->isOn());
-
-        gate.setFrequency (freq);
-        gate.setAttack (modMatrix.getValue (gateParams.attack));
-        gate.setRelease (modMatrix.getValue (gateParams.release));
+        s.gateFreq    = 1.0f / gin::NoteDuration::getNoteDurations()[size_t (gateParams.beat->getProcValue())].toSeconds (playhead);
+        s.gateAttack  = getMonoValue (gateParams.attack);
+        s.gateRelease = getMonoValue (gateParams.release);
     }
 
-    // Update Chorus
+    // Chorus
     if (chorusParams.enable->isOn())
     {
-        chorus.setParams (modMatrix.getValue (chorusParams.delay),
-                          modMatrix.getValue (chorusParams.rate),
-                          modMatrix.getValue (chorusParams.depth),
-                          modMatrix.getValue (chorusParams.width),
-                          modMatrix.getValue (chorusParams.mix));
+        s.chorus = { getMonoValue (chorusParams.delay),
+                     getMonoValue (chorusParams.rate),
+                     getMonoValue (chorusParams.depth),
+                     getMonoValue (chorusParams.width),
+                     chorusMixSmoother.process (modMatrix.getValue (chorusParams.mix), newBlockSize) };
     }
 
-    // Update Distortion
+    // Distortion
     if (distortionParams.enable->isOn())
     {
+        auto amp = [this] (gin::Parameter* p0, gin::Parameter* p1, gin::Parameter* p2, gin::Parameter* p3) -> std::array<float, 4>
+        {
+            return { getMonoValue (p0), getMonoValue (p1), getMonoValue (p2), getMonoValue (p3) };
+        };
+
         auto mode = fxParams.distMode->getUserValueInt();
         if (mode == 0)
-        {
-            distortionVal = modMatrix.getValue (distortionParams.amount);
-        }
+            s.distortion = getMonoValue (distortionParams.amount);
         else if (mode == 1)
-        {
-            bitcrusher.setParameter (0, modMatrix.getValue (bitcrusherParams.rez));
-            bitcrusher.setParameter (1, modMatrix.getValue (bitcrusherParams.rate));
-            bitcrusher.setParameter (2, modMatrix.getValue (bitcrusherParams.hard));
-            bitcrusher.setParameter (3, modMatrix.getValue (bitcrusherParams.mix));
-        }
+            s.amp = amp (bitcrusherParams.rez, bitcrusherParams.rate, bitcrusherParams.hard, bitcrusherParams.mix);
         else if (mode == 2)
-        {
-            fireAmp.setParameter (0, modMatrix.getValue (fireAmpParams.gain));
-            fireAmp.setParameter (1, modMatrix.getValue (fireAmpParams.tone));
-            fireAmp.setParameter (2, modMatrix.getValue (fireAmpParams.output));
-            fireAmp.setParameter (3, modMatrix.getValue (fireAmpParams.mix));
-        }
+            s.amp = amp (fireAmpParams.gain, fireAmpParams.tone, fireAmpParams.output, fireAmpParams.mix);
         else if (mode == 3)
-        {
-            grindAmp.setParameter (0, modMatrix.getValue (grindAmpParams.gain));
-            grindAmp.setParameter (1, modMatrix.getValue (grindAmpParams.tone));
-            grindAmp.setParameter (2, modMatrix.getValue (grindAmpParams.output));
-            grindAmp.setParameter (3, modMatrix.getValue (grindAmpParams.mix));
-        }
+            s.amp = amp (grindAmpParams.gain, grindAmpParams.tone, grindAmpParams.output, grindAmpParams.mix);
     }
 
-    // Update Delay
+    // Delay
     if (delayParams.enable->isOn())
     {
+        // Synced times jump with the tempo, free times glide. The smoother
+        // follows both so switching modes glides from where it was.
+        float time;
         if (delayParams.sync->isOn())
         {
             auto& duration = gin::NoteDuration::getNoteDurations()[(size_t)modMatrix.getValue (delayParams.beat)];
-            delayParams.delay->setUserValue (duration.toSeconds (getPlayHead()));
-            stereoDelay.setParams (delayParams.delay->getUserValue(),
-                                   modMatrix.getValue (delayParams.mix),
-                                   modMatrix.getValue (delayParams.fb),
-                                   modMatrix.getValue (delayParams.cf));
+            time = duration.toSeconds (playhead);
+            delayTimeSmoother.process (time, newBlockSize);
         }
         else
         {
-            delayParams.delay->setUserValue (modMatrix.getValue (delayParams.time));
-            stereoDelay.setParams (modMatrix.getValue (delayParams.delay),
-                                   modMatrix.getValue (delayParams.mix),
-                                   modMatrix.getValue (delayParams.fb),
-                                   modMatrix.getValue (delayParams.cf));
+            time = delayTimeSmoother.process (modMatrix.getValue (delayParams.time), newBlockSize);
         }
+
+        s.delay = { time,
+                    delayMixSmoother.process (modMatrix.getValue (delayParams.mix), newBlockSize),
+                    getMonoValue (delayParams.fb),
+                    getMonoValue (delayParams.cf) };
     }
 
-    // Update Reverb
+    // Reverb
     if (reverbParams.enable->isOn())
     {
-        reverb.setSize (modMatrix.getValue (reverbParams.size));
-        reverb.setDecay (modMatrix.getValue (reverbParams.decay));
-        reverb.setLowpass (modMatrix.getValue (reverbParams.lowpass));
-        reverb.setDamping (modMatrix.getValue (reverbParams.damping));
-        reverb.setPredelay (modMatrix.getValue (reverbParams.predelay));
-        reverb.setMix (modMatrix.getValue (reverbParams.mix));
+        s.reverb = { getMonoValue (reverbParams.size),
+                     getMonoValue (reverbParams.decay),
+                     getMonoValue (reverbParams.lowpass),
+                     getMonoValue (reverbParams.damping),
+                     getMonoValue (reverbParams.predelay),
+                     reverbMixSmoother.process (modMatrix.getValue (reverbParams.mix), newBlockSize) };
     }
 
     // Output gain
-    outputGain.setGain (modMatrix.getValue (globalParams.level));
+    s.gain = levelSmoother.process (modMatrix.getValue (globalParams.level), newBlockSize);
 }
 
-bool WavetableAudioProcessor::loadWaveTable (gin::Wavetable& table, double sr, const juce::MemoryBlock& wav, const juce::String& format, int size)
+bool WavetableAudioProcessor::loadWaveTable (int osc, double sr, const juce::MemoryBlock& wav, const juce::String& format, int size)
 {
+    WT_TRACE_SCOPE ("loadWaveTable");
+
+    auto& table = osc == 0 ? osc1Tables : osc2Tables;
+
     auto is = new juce::MemoryInputStream (wav, false);
 
     if (format == "wav")
@@ -1300,6 +2065,7 @@ bool WavetableAudioProcessor::loadWaveTable (gin::Wavetable& table, double sr, c
 
                 gin::Wavetable t;
                 loadWavetables (t, sr, buf, reader->sampleRate, size);
+                updateWavetablePreview (osc, buf, size);
 
                 juce::ScopedLock sl (dspLock);
                 std::swap (t, table);
@@ -1317,6 +2083,7 @@ bool WavetableAudioProcessor::loadWaveTable (gin::Wavetable& table, double sr, c
 
             gin::Wavetable t;
             loadWavetables (t, sr, buf, reader->sampleRate, 2048);
+            updateWavetablePreview (osc, buf, 2048);
 
             juce::ScopedLock sl (dspLock);
             std::swap (t, table);
@@ -1328,6 +2095,26 @@ bool WavetableAudioProcessor::loadWaveTable (gin::Wavetable& table, double sr, c
     return false;
 }
 
+void WavetableAudioProcessor::updateWavetablePreview (int osc, const juce::AudioSampleBuffer& frames, int size)
+{
+    auto preview = WavetablePreview::create (frames, size);
+
+    auto& p = previews[osc];
+    {
+        juce::SpinLock::ScopedLockType sl (p.lock);
+        std::swap (p.preview, preview);
+    }
+    p.version++;
+}
+
+std::shared_ptr<const WavetablePreview> WavetableAudioProcessor::getWavetablePreview (int osc)
+{
+    auto& p = previews[osc];
+
+    juce::SpinLock::ScopedLockType sl (p.lock);
+    return p.preview;
+}
+
 void WavetableAudioProcessor::handleMidiEvent (const juce::MidiMessage& m)
 {
     gin::Synthesiser::handleMidiEvent (m);
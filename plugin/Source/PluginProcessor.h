@@ -1,8 +1,19 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <span>
 
 #include "WavetableVoice.h"
+#include "ModProfiler.h"
+#include "TailSleeper.h"
+#include "ParamSmoothers.h"
+#include "Oversampler.h"
+#include "FXPipeline.h"
+#include "ScopeFeed.h"
+#include "WavetablePreview.h"
+#include "WavetableIndex.h"
+#include "Trace.h"
+#include "MTS-ESP/Client/libMTSClient.h"
 #include "FX/DeRez2.h"
 #include "FX/FireAmp.h"
 #include "FX/GrindAmp.h"
@@ -13,9 +24,88 @@ constexpr auto fxDistort    = 2;
 constexpr auto fxDelay      = 3;
 constexpr auto fxReverb     = 4;
 
+//==============================================================================
+/** Remembers the last values pushed into an effect, so its setters only need
+    to run when one of them has moved by more than a small relative epsilon.
+*/
+template <size_t N>
+struct EffectParamCache
+{
+    bool update (const std::array<float, N>& v)
+    {
+        auto changed = ! valid;
+        for (size_t i = 0; i < N && ! changed; i++)
+            changed = std::abs (v[i] - values[i]) > 1.0e-6f * std::max (1.0f, std::abs (values[i]));
+
+        if (changed)
+        {
+            values = v;
+            valid = true;
+        }
+        return changed;
+    }
+
+    void invalidate()                       { valid = false;    }
+
+    std::array<float, N> values {};
+    bool valid = false;
+};
+
+//==============================================================================
+/** Eased smoothing for a mono parameter, done on the processor side rather than
+    in the mod matrix. Once the value has reached its target it is returned
+    directly, without running the smoother.
+*/
+struct EasedParamSmoother
+{
+    void setSampleRate (double sr)          { smoother.setSampleRate (sr); }
+    void setTime (float t)                  { smoother.setTime (t);        }
+    void reset()                            { hasValue = false;            }
+
+    float process (float newTarget, int numSamples)
+    {
+        if (! hasValue)
+        {
+            hasValue = true;
+            settled = true;
+            target = newTarget;
+            smoother.setValueUnsmoothed (target);
+            return target;
+        }
+
+        if (newTarget != target)
+        {
+            target = newTarget;
+            settled = false;
+            smoother.setValue (target);
+        }
+
+        if (settled)
+            return target;
+
+        smoother.process (numSamples);
+
+        auto v = smoother.getCurrentValue();
+        if (std::abs (v - target) < 1.0e-5f)
+        {
+            smoother.setValueUnsmoothed (target);
+            settled = true;
+            return target;
+        }
+        return v;
+    }
+
+    gin::EasedValueSmoother<float> smoother;
+    float target = 0.0f;
+    bool hasValue = false, settled = true;
+};
+
 //==============================================================================
 class WavetableAudioProcessor : public gin::Processor,
-                                public gin::Synthesiser
+                                public gin::Synthesiser,
+                                private gin::ModMatrix::Listener,
+                                private gin::Parameter::ParameterListener,
+                                private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -42,13 +132,70 @@ public:
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
 
+    //==============================================================================
+    /** Effect parameters for one 32 sample slice. The voices are rendered slice
+        by slice first, then each effect runs over the whole batch, see
+        applyEffects().
+    */
+    struct FXSnapshot
+    {
+        int numSamples = 0;
+        int noteOnIndex = -1, noteOffIndex = -1;
+
+        float gateFreq = 0.0f, gateAttack = 0.0f, gateRelease = 0.0f;
+        std::array<float, 5> chorus {};
+        float distortion = 0.0f;
+        std::array<float, 4> amp {};
+        std::array<float, 4> delay {};
+        std::array<float, 6> reverb {};
+        float gain = 0.0f;
+
+        bool sameGate (const FXSnapshot& other) const;
+        bool sameChorus (const FXSnapshot& other) const;
+        bool sameDistortion (const FXSnapshot& other) const;
+        bool sameDelay (const FXSnapshot& other) const;
+        bool sameReverb (const FXSnapshot& other) const;
+    };
+
+    /** Effects that can't ramp their parameters take new values at most this
+        often, in samples, rather than every slice they change in */
+    static constexpr int minParamRun = 128;
+
     void updateParams (int blockSize);
+    void updateFXParams (FXSnapshot& snapshot, int blockSize);
     void setupModMatrix();
 
     //==============================================================================
     void handleMidiEvent (const juce::MidiMessage& m) override;
     void handleController (int ch, int num, int val) override;
     //==============================================================================
+    void invalidateEffectParams();
+
+    /** Fraction of blocks that took the idle fast path */
+    double getIdleRatio() const;
+
+    /** Audio problems since the plugin loaded or the counters were last reset,
+        to line up with reports of notes cutting out */
+    struct DropoutStats
+    {
+        juce::int64 blocks = 0;
+        juce::int64 missedBlocks = 0;       // skipped, the dsp lock was held elsewhere
+        juce::int64 voiceKills = 0;         // sounding voices cut off after a missed block
+        juce::int64 overDeadline = 0;       // took longer to render than the block lasts
+        double worstRenderMs = 0.0;
+        juce::int64 lastDropoutTime = 0;    // juce::Time::currentTimeMillis(), 0 if none yet
+    };
+
+    DropoutStats getDropoutStats() const;
+    void resetDropoutStats();
+
+    /** Runs the effects a block behind the voices on a second thread. Call
+        from the message thread, the change adds or removes a block of latency.
+        The audio thread switches over at the start of its next block. */
+    void setFXThreadEnabled (bool enabled);
+    bool isFXThreadEnabled() const          { return fxThreadEnabled; }
+
+    // Message thread, from the voice telemetry the audio thread publishes each block
     juce::Array<float> getLiveFilterCutoff();
     gin::WTOscillator::Params getLiveWTParams (int osc);
 
@@ -58,10 +205,14 @@ public:
     juce::StringArray getWavetableNames() const;
     juce::Array<juce::File> getWavetableFiles() const;
 
-    void applyEffects (juce::AudioSampleBuffer& buffer);
-    void applyEffect (juce::AudioSampleBuffer& buffer, int fxId);
+    void applyEffects (juce::AudioSampleBuffer& buffer, const std::vector<FXSnapshot>& snapshots, int startSample, int numSnapshots);
+
+    bool loadWaveTable (int osc, double sr, const juce::MemoryBlock& wav, const juce::String& format, int size);
 
-    bool loadWaveTable (gin::Wavetable& table, double sr, const juce::MemoryBlock& wav, const juce::String& format, int size);
+    /** What the editor draws of an oscillator's wavetable. The version goes
+        up each time it's replaced. */
+    std::shared_ptr<const WavetablePreview> getWavetablePreview (int osc);
+    int getWavetablePreviewVersion (int osc) const  { return previews[osc].version.load(); }
 
     // Voice Params
     struct OSCParams
@@ -160,7 +311,7 @@ public:
     {
         GlobalParams() = default;
 
-        gin::Parameter::Ptr mono, glideMode, glideRate, legato, level, voices, mpe, pitchBend;
+        gin::Parameter::Ptr mono, glideMode, glideRate, legato, level, voices, mpe, pitchBend, fxQuality;
 
         void setup (WavetableAudioProcessor& p);
 
@@ -218,7 +369,7 @@ public:
     {
         DelayParams() = default;
 
-        gin::Parameter::Ptr enable, sync, time, beat, fb, cf, mix, delay;
+        gin::Parameter::Ptr enable, sync, time, beat, fb, cf, mix;
 
         void setup (WavetableAudioProcessor& p);
 
@@ -240,7 +391,7 @@ public:
     {
         FXParams() = default;
 
-        gin::Parameter::Ptr fx1, fx2, fx3, fx4, fx5, distMode;
+        gin::Parameter::Ptr fx1, fx2, fx3, fx4, fx5, distMode, distOversample;
 
         void setup (WavetableAudioProcessor& p);
 
@@ -315,28 +466,96 @@ public:
     gin::Modulation chorus { 0.5f };
     gin::StereoDelay stereoDelay { 120.1 };
     gin::PlateReverb<float, int> reverb;
-    gin::GainProcessor outputGain;
-    gin::AudioFifo scopeFifo { 2, 44100 };
-    float distortionVal = 0.0f;
+    // The output level ramps linearly from each slice's value to the next
+    float outputGain = 0.0f;
+    bool outputGainValid = false;
     DeRez2  bitcrusher;
     FireAmp fireAmp;
     GrindAmp grindAmp;
 
+    EffectParamCache<5> chorusCache;
+    EffectParamCache<4> bitcrusherCache, fireAmpCache, grindAmpCache, delayCache;
+    EffectParamCache<6> reverbCache;
+
+    EasedParamSmoother levelSmoother, chorusMixSmoother, delayMixSmoother, reverbMixSmoother;
+    EasedParamSmoother delayTimeSmoother;
+
+    // Linear smoothing for the matrix destinations, the voices each have their own
+    LinearParamSmoothers monoSmoothers;
+    std::vector<bool> linearSmoothed;
+
+    std::vector<FXSnapshot> fxSnapshots;
+
+    // With the FX thread on, the snapshots for the job in flight are swapped
+    // out of fxSnapshots so the audio thread can fill the next block's
+    FXPipeline fxPipeline;
+    std::vector<FXSnapshot> jobSnapshots;
+    int jobNumSnapshots = 0;
+    int fxJobSize = 0;
+    std::atomic<bool> fxThreadEnabled { false };
+    bool fxThreadActive = false;        // audio thread, whether it's using the worker
+    juce::int64 blockDeadline = 0;      // when the output is due, in high resolution ticks
+
+    // Effect state changes from the audio thread, applied while the effects are idle
+    bool resetEffectTails = false, fxDoublePrecision = true;
+
+    TailSleeper chorusSleeper, delaySleeper, reverbSleeper;
+
+    HalfBandOversampler distOversampler;
+    int oversamplerFlush = 0;           // samples of silence still to render before idling
+
+    std::atomic<juce::int64> totalBlocks { 0 }, idleBlocks { 0 };
+
+    std::atomic<juce::int64> missedBlocks { 0 }, voiceKills { 0 }, overDeadlineBlocks { 0 }, lastDropoutTime { 0 };
+    std::atomic<double> worstRenderMs { 0.0 };
+
     gin::Wavetable osc1Tables;
     gin::Wavetable osc2Tables;
 
+    struct PreviewSlot
+    {
+        juce::SpinLock lock;
+        std::shared_ptr<const WavetablePreview> preview;
+        std::atomic<int> version { 0 };
+    };
+
+    PreviewSlot previews[Cfg::numOSCs];
+
+    void updateWavetablePreview (int osc, const juce::AudioSampleBuffer& frames, int size);
+
     gin::BandLimitedLookupTables analogTables;
 
     juce::Value osc1Table, osc2Table;
+
+    // Names and thumbnails for the browser, shared by all instances
+    juce::SharedResourcePointer<WavetableIndex> wavetableIndex;
     juce::MemoryBlock userTable1, userTable2;
     int osc1Size = -1, osc2Size = -1;
 
     //==============================================================================
     gin::ModMatrix modMatrix;
+    ModProfiler modProfiler;
+
+    // Output for the editor's scope, only written while an editor is attached
+    ScopeFeed scopeFeed;
+
+    std::vector<WavetableVoice*> wavetableVoices;
+    TripleBuffer<TelemetryFrame> telemetry;
 
     gin::LFO modLFOs[Cfg::numLFOs];
     gin::StepLFO modStepLFO;
 
+    // The host's position, read once per block. Every tempo synced LFO, the
+    // gate and the delay ask for it, and each call on the host's play head
+    // can go back into the host.
+    struct BlockPlayHead : public juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override  { return position; }
+
+        juce::Optional<PositionInfo> position;
+    };
+
+    BlockPlayHead blockPlayHead;
     juce::AudioPlayHead* playhead = nullptr;
     bool blockMissed = false;
     bool presetLoaded = false;
@@ -355,9 +574,81 @@ public:
 
 	MTSClient* mtsClient = nullptr;
 
+    // Per note MTS-ESP retuning. Only the audio thread writes it, just before
+    // the voices read it in the same block.
+    float getRetuneSemitones (int note) const   { return retuneTable[size_t (note & 127)]; }
+
 private:
+    void modMatrixChanged() override;
+    void valueUpdated (gin::Parameter*) override;
+    void handleAsyncUpdate() override;
+
+    //==============================================================================
+    // The FX order and enable state compiled into a list of effects to run. Only
+    // rebuilt when one of the parameters it depends on changes.
+    using EffectFn = void (WavetableAudioProcessor::*) (juce::AudioSampleBuffer&, std::span<const FXSnapshot>);
+
+    // One distortion mode over a stretch with fixed parameters, run by the
+    // distortion slot at the base or the oversampled rate
+    using DistortionFn = void (WavetableAudioProcessor::*) (juce::AudioSampleBuffer&, const FXSnapshot&);
+
+    juce::Array<gin::Parameter*> getEffectChainParams();
+    void updateEffectChain();
+    void updateEffectState();
+    void updateLatency();   // message thread only
+    void updateFXThread();
+
+    void processEffects (juce::AudioSampleBuffer& buffer, int startSample, int numSamples, int numSnapshots);
+
+    bool isIdle (const juce::MidiBuffer& midi);
+    void publishTelemetry();
+    void finishBlockTiming (juce::int64 startTicks, int numSamples);
+    void noteDropout();
+
+    template <typename Same, typename Fn>
+    void forEachParamRun (juce::AudioSampleBuffer& buffer, std::span<const FXSnapshot> slices, bool splitAtNotes, Same same, Fn fn);
+
+    void setGateParams (const FXSnapshot&);
+    void setChorusParams (const FXSnapshot&);
+    void setDistortionParams (const FXSnapshot&);
+    void setDelayParams (const FXSnapshot&);
+    void setReverbParams (const FXSnapshot&);
+
+    void processGate (juce::AudioSampleBuffer&, std::span<const FXSnapshot>);
+    void processChorus (juce::AudioSampleBuffer&, std::span<const FXSnapshot>);
+    void processDistortionSlot (juce::AudioSampleBuffer&, std::span<const FXSnapshot>);
+    void processDelay (juce::AudioSampleBuffer&, std::span<const FXSnapshot>);
+    void processDelaySmoothed (juce::AudioSampleBuffer&, std::span<const FXSnapshot>);
+    void processReverb (juce::AudioSampleBuffer&, std::span<const FXSnapshot>);
+
+    void processDistortion (juce::AudioSampleBuffer&, const FXSnapshot&);
+    void processBitcrusher (juce::AudioSampleBuffer&, const FXSnapshot&);
+    void processFireAmp (juce::AudioSampleBuffer&, const FXSnapshot&);
+    void processGrindAmp (juce::AudioSampleBuffer&, const FXSnapshot&);
+
+    std::array<EffectFn, 5> effectChain {};
+    int effectChainSize = 0;
+    DistortionFn distortionFn = nullptr;   // the mode processDistortionSlot runs, if the distortion is on
+    std::atomic<bool> effectChainDirty { true };
+    void updateRetuneTable (bool force, int numSamples);
+
+    std::array<float, 128> retuneTable {};
+    bool mtsHadMaster = false;
+    int retuneSamplesLeft = 0;
+
+    juce::SortedSet<int> polyModDsts;
+
     bool isParamLocked (gin::Parameter* p) override;
-    float getSmoothingTime (gin::Parameter*);
+
+    enum class Smoothing
+    {
+        none,       // discrete values, jump straight to the new value
+        linear,     // smoothed by LinearParamSmoothers
+        eased,      // smoothed by an EasedParamSmoother in the processor
+    };
+
+    Smoothing getSmoothingPolicy (gin::Parameter*);
+    float getMonoValue (gin::Parameter*);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WavetableAudioProcessor)
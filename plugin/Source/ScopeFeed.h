@@ -0,0 +1,161 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Feeds the editor's scope with the output reduced to display resolution.
+
+    Each run of `decimation` samples becomes a min/max pair, written in the
+    order they occurred so edges keep their shape, and the pairs go through a
+    lock-free single producer / single consumer fifo. Nothing is written while
+    no editor is attached.
+
+    The fifo holds a quarter second at the current sample rate. prepare()
+    resizes it when the rate changes, going through the same handshake as the
+    editor: deactivate, which waits for the audio thread to stop writing, then
+    resize, then reactivate if the editor had it on. setActive() clears it on
+    the message thread when the editor attaches.
+*/
+class ScopeFeed
+{
+public:
+    /** Input samples per min/max pair. With the scope drawing one pair per
+        pixel this shows the same time span as drawing the raw output at
+        four samples per pixel. */
+    static constexpr int decimation = 4;
+
+    ScopeFeed() = default;
+
+    gin::AudioFifo& getFifo()               { return fifo; }
+
+    /** From prepareToPlay. Longer blocks are decimated in chunks of at most
+        maxBlockSize, rounded down to whole pairs. */
+    void prepare (double sampleRate, int maxBlockSize)
+    {
+        auto capacity = 2 * int (std::ceil (sampleRate * 0.25 / decimation));
+        if (capacity != fifoCapacity)
+        {
+            auto wasActive = active.load();
+            setActive (false);
+
+            fifo.setSize (2, capacity);
+            fifoCapacity = capacity;
+
+            if (wasActive)
+                setActive (true);
+        }
+
+        maxChunk = std::max (decimation, maxBlockSize / decimation * decimation);
+
+        // Fewer than decimation samples carry over between chunks, so a whole
+        // number of runs never finishes more pairs than it has runs
+        scratch.setSize (2, 2 * (maxChunk / decimation));
+        reset();
+    }
+
+    void reset()
+    {
+        count = 0;
+        for (auto& b : buckets)
+            b = {};
+    }
+
+    /** Message thread, the editor turns this on while it's open */
+    void setActive (bool shouldBeActive)
+    {
+        if (! shouldBeActive)
+        {
+            active = false;
+
+            // A block that saw the feed as active may still be writing
+            while (writing)
+                std::this_thread::yield();
+
+            return;
+        }
+
+        fifo.clear();
+        active = true;
+    }
+
+    /** Audio thread, with the finished output */
+    void process (const juce::AudioSampleBuffer& buffer)
+    {
+        // Set before checking active, setActive (false) waits for it to clear
+        writing = true;
+
+        // Nothing to decimate into until prepared
+        if (active && maxChunk > 0 && buffer.getNumChannels() >= 2)
+        {
+            auto numSamples = buffer.getNumSamples();
+
+            for (int pos = 0; pos < numSamples; pos += maxChunk)
+                decimate (buffer, pos, std::min (maxChunk, numSamples - pos));
+        }
+
+        writing = false;
+    }
+
+private:
+    struct Bucket
+    {
+        float lo = 0.0f, hi = 0.0f;
+        int loIdx = 0, hiIdx = 0;
+    };
+
+    void decimate (const juce::AudioSampleBuffer& buffer, int start, int numSamples)
+    {
+        int numOut = 0;
+        int startCount = count;
+
+        for (int ch = 0; ch < 2; ch++)
+        {
+            auto in = buffer.getReadPointer (ch, start);
+            auto out = scratch.getWritePointer (ch);
+            auto& b = buckets[size_t (ch)];
+            int n = startCount, o = 0;
+
+            for (int i = 0; i < numSamples; i++)
+            {
+                auto s = in[i];
+
+                if (n == 0)
+                {
+                    b = { s, s, 0, 0 };
+                }
+                else
+                {
+                    if (s < b.lo) { b.lo = s; b.loIdx = n; }
+                    if (s > b.hi) { b.hi = s; b.hiIdx = n; }
+                }
+
+                if (++n == decimation)
+                {
+                    out[o++] = b.loIdx <= b.hiIdx ? b.lo : b.hi;
+                    out[o++] = b.loIdx <= b.hiIdx ? b.hi : b.lo;
+                    n = 0;
+                }
+            }
+
+            count = n;
+            numOut = o;
+        }
+
+        // The scope catches up on the next timer tick, pairs that don't fit are dropped
+        if (numOut > 0 && numOut <= fifo.getFreeSpace())
+        {
+            auto slice = gin::sliceBuffer (scratch, 0, numOut);
+            fifo.write (slice);
+        }
+    }
+
+    gin::AudioFifo fifo;
+    juce::AudioSampleBuffer scratch;
+
+    std::array<Bucket, 2> buckets;
+    int count = 0, maxChunk = 0, fifoCapacity = 0;
+
+    std::atomic<bool> active { false }, writing { false };
+
+    JUCE_DECLARE_NON_COPYABLE (ScopeFeed)
+};
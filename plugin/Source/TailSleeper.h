@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Lets a time based effect skip processing silence once its tail has died
+    away.
+
+    The effect keeps running while there is input, or while its output has been
+    below the threshold for less than the hold time. The hold time has to cover
+    the longest gap the effect can leave between input and output, e.g. the delay
+    time. Once it's asleep the effect should be reset, and it isn't processed
+    again until the input is no longer silent.
+*/
+class TailSleeper
+{
+public:
+    void setSampleRate (double sr)          { sampleRate = sr; updateHold(); }
+    void setHoldTime (double seconds)       { holdTime = seconds; updateHold(); }
+
+    void reset()
+    {
+        asleep = false;
+        silentSamples = 0;
+    }
+
+    bool isAsleep() const                   { return asleep; }
+
+    /** Call with the input before processing, returns false if the effect can be skipped */
+    bool shouldProcess (const juce::AudioSampleBuffer& buffer)
+    {
+        inputSilent = isSilent (buffer);
+
+        if (asleep && ! inputSilent)
+            reset();
+
+        return ! asleep;
+    }
+
+    /** Call with the output after processing, returns true if the effect has just
+        gone to sleep and should be reset */
+    bool processed (const juce::AudioSampleBuffer& buffer)
+    {
+        if (! inputSilent || ! isSilent (buffer))
+        {
+            silentSamples = 0;
+            return false;
+        }
+
+        silentSamples += buffer.getNumSamples();
+        asleep = silentSamples >= holdSamples;
+        return asleep;
+    }
+
+private:
+    static bool isSilent (const juce::AudioSampleBuffer& buffer)
+    {
+        constexpr float threshold = 1.0e-5f; // -100 dB
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ch++)
+            if (buffer.getMagnitude (ch, 0, buffer.getNumSamples()) > threshold)
+                return false;
+
+        return true;
+    }
+
+    void updateHold()                       { holdSamples = juce::int64 (std::ceil (holdTime * sampleRate)); }
+
+    double sampleRate = 44100.0, holdTime = 0.25;
+    juce::int64 holdSamples = 11025, silentSamples = 0;
+    bool asleep = false, inputSilent = false;
+};
@@ -0,0 +1,356 @@
+#include "Trace.h"
+
+#if WT_TRACING
+
+namespace
+{
+    constexpr int maxThreads = 32;
+    constexpr uint32_t ringSize = 1 << 14;
+
+    struct Event
+    {
+        const char* name;
+        juce::int64 ticks;
+        char phase;
+    };
+
+    /** Single producer, the thread that claimed it, and single consumer, the writer */
+    struct ThreadRing
+    {
+        std::atomic<uint32_t> head { 0 }, tail { 0 };
+        std::array<Event, ringSize> events;
+
+        // Producer side only. Begins are only taken while there's room for
+        // all their ends, so an end never has to be dropped.
+        int depth = 0;
+
+        bool push (const Event& e)
+        {
+            auto h = head.load (std::memory_order_relaxed);
+            if (h - tail.load (std::memory_order_acquire) >= ringSize)
+                return false;
+
+            events[h % ringSize] = e;
+            head.store (h + 1, std::memory_order_release);
+            return true;
+        }
+
+        uint32_t freeSpace() const
+        {
+            return ringSize - (head.load (std::memory_order_relaxed) - tail.load (std::memory_order_acquire));
+        }
+
+        std::atomic<int> session { 0 };
+        char threadName[32] = {};
+    };
+
+    /** The handshake that lets a new recording reset the rings in place.
+        Producers count themselves into inFlight before checking whether they
+        may write. Stopping clears the flags first and then waits for inFlight
+        to drain, after which nothing is inside a ring or can get into one.
+        While a recording stops, ends are still written so open scopes can
+        close, but begins aren't. */
+    std::atomic<bool> writable { false };
+    std::atomic<int> inFlight { 0 };
+
+    // Begins recorded and not yet ended, across recordings
+    std::atomic<int> openScopes { 0 };
+
+    struct ProducerGuard
+    {
+        ProducerGuard()                 { inFlight.fetch_add (1); }
+        ~ProducerGuard()                { inFlight.fetch_sub (1, std::memory_order_release); }
+
+        JUCE_DECLARE_NON_COPYABLE (ProducerGuard)
+    };
+
+    void waitForQuiescence()
+    {
+        // Scopes on the audio thread last a block at most, anything open
+        // longer than this is left unmatched in the file
+        auto deadline = juce::Time::getMillisecondCounter() + 200;
+        while (openScopes.load() > 0 && juce::Time::getMillisecondCounter() < deadline)
+            juce::Thread::sleep (1);
+
+        writable = false;
+
+        // Only a push or two away from done
+        while (inFlight.load() > 0)
+            juce::Thread::yield();
+    }
+
+    class Writer;
+
+    // Created by the first start() and kept until JUCE shuts down, so a
+    // thread still holding a ring never sees it freed
+    Writer* writer = nullptr;
+    juce::CriticalSection writerLock;
+
+    class Writer : public juce::Thread,
+                   public juce::DeletedAtShutdown
+    {
+    public:
+        Writer() : juce::Thread ("Trace Writer")
+        {
+            for (auto& r : rings)
+                r = std::make_unique<ThreadRing>();
+        }
+
+        ~Writer() override
+        {
+            Trace::stop();
+            close();
+            writer = nullptr;
+        }
+
+        ThreadRing* claim (int currentSession)
+        {
+            auto idx = numClaimed.fetch_add (1);
+            if (idx >= maxThreads)
+                return nullptr;
+
+            auto& r = *rings[size_t (idx)];
+            r.depth = 0;
+
+            // This may be the host's audio thread, so no new strings. Copying
+            // a thread's name only bumps a reference count.
+            if (juce::MessageManager::existsAndIsCurrentThread())
+                std::snprintf (r.threadName, sizeof (r.threadName), "Message");
+            else if (auto t = juce::Thread::getCurrentThread())
+                t->getThreadName().copyToUTF8 (r.threadName, sizeof (r.threadName));
+            else
+                std::snprintf (r.threadName, sizeof (r.threadName), "Thread %d", idx + 1);
+
+            r.session.store (currentSession, std::memory_order_release);
+            return &r;
+        }
+
+        /** Only once quiescent, nothing may be pushing to the rings */
+        bool open (const juce::File& f)
+        {
+            file = f;
+            file.getParentDirectory().createDirectory();
+            file.deleteFile();
+
+            out = std::make_unique<juce::FileOutputStream> (file);
+            if (! out->openedOk())
+            {
+                out = nullptr;
+                return false;
+            }
+
+            *out << "{\"traceEvents\":[\n";
+            *out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Wavetable\"}}";
+
+            startTicks = juce::Time::getHighResolutionTicks();
+
+            for (auto& r : rings)
+            {
+                r->head = 0;
+                r->tail = 0;
+            }
+
+            numClaimed = 0;
+            namesWritten = 0;
+            session++;
+
+            startThread (juce::Thread::Priority::low);
+            return true;
+        }
+
+        void close()
+        {
+            stopThread (2000);
+
+            if (out != nullptr)
+            {
+                drain();
+                *out << "\n]}\n";
+                out = nullptr;
+            }
+        }
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                drain();
+                wait (20);
+            }
+        }
+
+        std::atomic<int> session { 0 };
+        juce::File file;
+
+    private:
+        void drain()
+        {
+            if (out == nullptr)
+                return;
+
+            auto claimed = std::min (numClaimed.load(), maxThreads);
+
+            for (int i = 0; i < claimed; i++)
+            {
+                auto& r = *rings[size_t (i)];
+                if (r.session.load (std::memory_order_acquire) != session)
+                    continue;
+
+                if (i >= namesWritten)
+                {
+                    *out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (i + 1)
+                         << ",\"args\":{\"name\":\"" << juce::String (r.threadName) << "\"}}";
+                    namesWritten = i + 1;
+                }
+
+                auto t = r.tail.load (std::memory_order_relaxed);
+                auto h = r.head.load (std::memory_order_acquire);
+
+                for (; t != h; t++)
+                {
+                    auto& e = r.events[t % ringSize];
+                    auto us = juce::Time::highResolutionTicksToSeconds (e.ticks - startTicks) * 1.0e6;
+
+                    *out << ",\n{\"name\":\"" << e.name << "\",\"ph\":\"" << juce::String::charToString (e.phase) << "\",\"ts\":" << juce::String (us, 3)
+                         << ",\"pid\":1,\"tid\":" << (i + 1);
+
+                    if (e.phase == 'i')
+                        *out << ",\"s\":\"t\"";
+
+                    *out << "}";
+                }
+
+                r.tail.store (t, std::memory_order_release);
+            }
+
+            out->flush();
+        }
+
+        std::array<std::unique_ptr<ThreadRing>, maxThreads> rings;
+        std::atomic<int> numClaimed { 0 };
+        int namesWritten = 0;
+
+        std::unique_ptr<juce::FileOutputStream> out;
+        juce::int64 startTicks = 0;
+    };
+
+    ThreadRing* getRing()
+    {
+        struct Claim
+        {
+            int session = -1;
+            ThreadRing* ring = nullptr;
+        };
+
+        thread_local Claim claim;
+
+        auto current = writer->session.load (std::memory_order_relaxed);
+        if (claim.session != current)
+        {
+            claim.session = current;
+            claim.ring = writer->claim (current);
+        }
+
+        return claim.ring;
+    }
+}
+
+std::atomic<bool> Trace::enabled { false };
+
+//==============================================================================
+bool Trace::start (const juce::File& file)
+{
+    juce::ScopedLock sl (writerLock);
+
+    if (writer == nullptr)
+        writer = new Writer();
+
+    if (enabled)
+    {
+        enabled = false;
+        waitForQuiescence();
+    }
+
+    writer->close();
+
+    if (! writer->open (file))
+        return false;
+
+    writable = true;
+    enabled = true;
+    return true;
+}
+
+void Trace::stop()
+{
+    juce::ScopedLock sl (writerLock);
+
+    if (writer == nullptr || ! enabled)
+        return;
+
+    enabled = false;
+    waitForQuiescence();
+    writer->close();
+}
+
+juce::File Trace::getFile()
+{
+    juce::ScopedLock sl (writerLock);
+    return writer != nullptr ? writer->file : juce::File();
+}
+
+bool Trace::begin (const char* name)
+{
+    if (! isRecording())
+        return false;
+
+    ProducerGuard g;
+    if (! enabled.load())
+        return false;
+
+    auto r = getRing();
+    if (r == nullptr)
+        return false;
+
+    if (r->freeSpace() <= uint32_t (r->depth + 1))
+        return false;
+
+    r->push ({ name, juce::Time::getHighResolutionTicks(), 'B' });
+    r->depth++;
+    openScopes.fetch_add (1, std::memory_order_relaxed);
+    return true;
+}
+
+void Trace::end (const char* name)
+{
+    // Only called for a begin that was recorded, which left room for this. If
+    // a new recording started in between, the begin went to the old file.
+    {
+        ProducerGuard g;
+        if (writable.load())
+        {
+            if (auto r = getRing(); r != nullptr && r->depth > 0)
+            {
+                r->push ({ name, juce::Time::getHighResolutionTicks(), 'E' });
+                r->depth--;
+            }
+        }
+    }
+
+    openScopes.fetch_sub (1, std::memory_order_release);
+}
+
+void Trace::instant (const char* name)
+{
+    if (! isRecording())
+        return;
+
+    ProducerGuard g;
+    if (! enabled.load())
+        return;
+
+    if (auto r = getRing(); r != nullptr && r->freeSpace() > uint32_t (r->depth + 1))
+        r->push ({ name, juce::Time::getHighResolutionTicks(), 'i' });
+}
+
+#endif
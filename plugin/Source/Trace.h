@@ -0,0 +1,64 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Timeline tracing for the audio pipeline, written as Chrome trace JSON that
+    Perfetto or chrome://tracing can open.
+
+    Only built with WAVETABLE_TRACING in CMake, otherwise the macros are empty.
+    Even then nothing is recorded until start() is called, from the editor's
+    menu, and until then each scope costs one relaxed load.
+
+    Each thread that records claims its own fixed size ring the first time it
+    does, so adding an event never locks or allocates. A writer thread drains
+    the rings to disk every few milliseconds. Names must be string literals, only
+    the pointer is stored.
+*/
+#if WT_TRACING
+
+class Trace
+{
+public:
+    /** Starts recording to the file, replacing a recording in progress.
+        False if the file couldn't be opened. */
+    static bool start (const juce::File& file);
+
+    /** Stops recording and finishes the file, once the scopes already open
+        have ended and no thread is writing to its ring */
+    static void stop();
+
+    static bool isRecording()                   { return enabled.load (std::memory_order_relaxed); }
+    static juce::File getFile();
+
+    //==============================================================================
+    static bool begin (const char* name);
+    static void end (const char* name);
+    static void instant (const char* name);
+
+    class Scope
+    {
+    public:
+        explicit Scope (const char* n) : name (n), active (begin (n)) {}
+        ~Scope()                                { if (active) end (name); }
+
+    private:
+        const char* name;
+        bool active;
+
+        JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+ #define WT_TRACE_SCOPE(name)       Trace::Scope JUCE_JOIN_MACRO (wtTraceScope, __LINE__) (name)
+ #define WT_TRACE_INSTANT(name)     Trace::instant (name)
+
+#else
+
+ #define WT_TRACE_SCOPE(name)
+ #define WT_TRACE_INSTANT(name)
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Cfg.h"
+
+//==============================================================================
+/** Hands a value from one writer thread to one reader thread without either
+    waiting. The writer always has a buffer of its own to fill, the reader
+    always gets the most recently published one complete.
+*/
+template <typename T>
+class TripleBuffer
+{
+public:
+    /** Writer: the buffer to fill in before publish() */
+    T& getWriteBuffer()                     { return buffers[size_t (back)]; }
+
+    void publish()
+    {
+        back = shared.exchange (back | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    /** Reader: the last published value, the same one again if nothing new
+        has been published since */
+    const T& read()
+    {
+        if ((shared.load (std::memory_order_relaxed) & freshBit) != 0)
+            front = shared.exchange (front, std::memory_order_acq_rel) & indexMask;
+
+        return buffers[size_t (front)];
+    }
+
+private:
+    static constexpr int freshBit = 4, indexMask = 3;
+
+    std::array<T, 3> buffers {};
+    std::atomic<int> shared { 1 };
+    int back = 0, front = 2;
+};
+
+//==============================================================================
+/** What the editor shows of a voice, copied out at the end of each block */
+struct VoiceTelemetry
+{
+    bool active = false;
+    float note = 0.0f;
+    float cutoff = 0.0f;        // 0 to 1 over the filter frequency range
+    float envelope = 0.0f;      // amp envelope level
+    gin::WTOscillator::Params wt[Cfg::numOSCs];
+};
+
+using TelemetryFrame = std::array<VoiceTelemetry, Cfg::numVoices>;
@@ -0,0 +1,155 @@
+#include "WavetableDisplay.h"
+
+//==============================================================================
+void WavetableDisplay::setPreview (std::shared_ptr<const WavetablePreview> p)
+{
+    if (p == preview)
+        return;
+
+    preview = std::move (p);
+    stackValid = false;
+    repaint();
+}
+
+void WavetableDisplay::setParams (const gin::WTOscillator::Params& p)
+{
+    if (juce::exactlyEqual (p.position, position)
+        && juce::exactlyEqual (p.bend, bend)
+        && juce::exactlyEqual (p.formant, formant))
+        return;
+
+    position = p.position;
+    bend = p.bend;
+    formant = p.formant;
+    repaint();
+}
+
+void WavetableDisplay::resized()
+{
+    stackValid = false;
+}
+
+//==============================================================================
+juce::Rectangle<float> WavetableDisplay::getFrameArea (float depth) const
+{
+    // Frames step back up and to the right, the first one is at the front
+    auto rc = getLocalBounds().toFloat().reduced (2.0f);
+
+    auto w = rc.getWidth() * 0.75f;
+    auto h = rc.getHeight() * 0.5f;
+
+    return { rc.getX() + (rc.getWidth() - w) * depth,
+             rc.getY() + (rc.getHeight() - h) * (1.0f - depth),
+             w, h };
+}
+
+juce::Path WavetableDisplay::getFramePath (const float* frame, juce::Rectangle<float> area, float bendAmount, float formantAmount) const
+{
+    const int size = preview->frameSize;
+    const bool warped = bendAmount != 0.0f || formantAmount != 0.0f;
+
+    // Bend skews the phase towards one end of the cycle, formant plays the
+    // cycle faster or slower and pads it with silence
+    const float bendPower = std::exp2 (-2.0f * bendAmount);
+    const float formantRate = std::exp2 (2.0f * formantAmount);
+
+    juce::Path p;
+
+    const int points = warped ? std::max (size, juce::roundToInt (area.getWidth())) : size;
+
+    for (int i = 0; i <= points; i++)
+    {
+        auto x = float (i) / float (points);
+        auto phase = x;
+
+        if (warped)
+            phase = std::pow (phase, bendPower) * formantRate;
+
+        float v = 0.0f;
+        if (phase < 1.0f)
+        {
+            auto pos = phase * float (size);
+            auto i0 = int (pos) % size;
+            auto i1 = (i0 + 1) % size;
+            auto frac = pos - std::floor (pos);
+            v = frame[i0] + (frame[i1] - frame[i0]) * frac;
+        }
+
+        auto px = area.getX() + x * area.getWidth();
+        auto py = area.getCentreY() - v * area.getHeight() * 0.5f;
+
+        if (i == 0)
+            p.startNewSubPath (px, py);
+        else
+            p.lineTo (px, py);
+    }
+
+    return p;
+}
+
+void WavetableDisplay::renderStack (float scale)
+{
+    stackScale = scale;
+    stackValid = true;
+
+    auto w = juce::roundToInt (getWidth() * scale);
+    auto h = juce::roundToInt (getHeight() * scale);
+
+    if (w <= 0 || h <= 0)
+    {
+        stack = {};
+        return;
+    }
+
+    stack = juce::Image (juce::Image::ARGB, w, h, true);
+
+    if (preview == nullptr || preview->numFrames == 0)
+        return;
+
+    juce::Graphics g (stack);
+    g.addTransform (juce::AffineTransform::scale (scale));
+
+    auto c = findColour (gin::PluginLookAndFeel::accentColourId, true);
+
+    // Back to front so nearer frames draw over further ones
+    for (int f = preview->numFrames - 1; f >= 0; f--)
+    {
+        auto depth = preview->numFrames > 1 ? float (f) / float (preview->numFrames - 1) : 0.0f;
+
+        g.setColour (c.withAlpha (0.1f + 0.15f * (1.0f - depth)));
+        g.strokePath (getFramePath (preview->getFrame (f), getFrameArea (depth), 0.0f, 0.0f), juce::PathStrokeType (0.75f));
+    }
+}
+
+void WavetableDisplay::paint (juce::Graphics& g)
+{
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (! stackValid || ! juce::exactlyEqual (scale, stackScale))
+        renderStack (scale);
+
+    if (stack.isValid())
+        g.drawImage (stack, getLocalBounds().toFloat());
+
+    if (preview == nullptr || preview->numFrames == 0)
+        return;
+
+    auto pos = juce::jlimit (0.0f, 1.0f, position) * float (preview->numFrames - 1);
+    auto frame = juce::jlimit (0, preview->numFrames - 1, juce::roundToInt (pos));
+    auto depth = preview->numFrames > 1 ? pos / float (preview->numFrames - 1) : 0.0f;
+
+    g.setColour (findColour (gin::PluginLookAndFeel::accentColourId, true));
+    g.strokePath (getFramePath (preview->getFrame (frame), getFrameArea (depth), bend, formant), juce::PathStrokeType (1.5f));
+}
+
+//==============================================================================
+bool WavetableDisplay::isInterestedInFileDrag (const juce::StringArray& files)
+{
+    return onFileDrop != nullptr && files.size() == 1 && files[0].endsWithIgnoreCase (".wav");
+}
+
+void WavetableDisplay::filesDropped (const juce::StringArray& files, int, int)
+{
+    if (onFileDrop && files.size() == 1)
+        onFileDrop (juce::File (files[0]));
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "WavetablePreview.h"
+
+//==============================================================================
+/** Draws an oscillator's wavetable as a stack of frames, with the frame at the
+    current position highlighted and warped by bend and formant.
+
+    The stack only changes with the table or the size, so it's rendered once
+    into an image. Each repaint draws that image and the one highlighted frame,
+    and setParams() only repaints when the params actually change.
+*/
+class WavetableDisplay : public juce::Component,
+                         public juce::FileDragAndDropTarget
+{
+public:
+    WavetableDisplay() = default;
+
+    void setPreview (std::shared_ptr<const WavetablePreview> p);
+    void setParams (const gin::WTOscillator::Params& p);
+
+    std::function<void (const juce::File&)> onFileDrop;
+
+    //==============================================================================
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+    bool isInterestedInFileDrag (const juce::StringArray& files) override;
+    void filesDropped (const juce::StringArray& files, int x, int y) override;
+
+private:
+    juce::Rectangle<float> getFrameArea (float depth) const;
+    juce::Path getFramePath (const float* frame, juce::Rectangle<float> area, float bend, float formant) const;
+
+    void renderStack (float scale);
+
+    std::shared_ptr<const WavetablePreview> preview;
+    float position = 0.0f, bend = 0.0f, formant = 0.0f;
+
+    juce::Image stack;
+    float stackScale = 0.0f;
+    bool stackValid = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WavetableDisplay)
+};
@@ -0,0 +1,346 @@
+#include "WavetableIndex.h"
+#include "Trace.h"
+
+namespace
+{
+    constexpr int cacheVersion = 2;
+
+    bool isBefore (const WavetableIndex::Entry& a, const WavetableIndex::Entry& b)
+    {
+        if (a.user != b.user)
+            return b.user;
+
+        auto categoryCmp = a.category.compareNatural (b.category);
+        if (categoryCmp != 0)
+            return categoryCmp < 0;
+
+        return a.name.compareNatural (b.name) < 0;
+    }
+}
+
+//==============================================================================
+WavetableIndex::WavetableIndex()
+    : juce::Thread ("Wavetable Index")
+{
+    snapshot = std::make_shared<Snapshot>();
+}
+
+WavetableIndex::~WavetableIndex()
+{
+    stopThread (5000);
+}
+
+void WavetableIndex::scan (const juce::File& factoryDir_, const juce::File& userDir_, const juce::File& cacheFile_)
+{
+    {
+        juce::ScopedLock sl (folderLock);
+        factoryDir = factoryDir_;
+        userDir = userDir_;
+        cacheFile = cacheFile_;
+    }
+
+    rescan();
+}
+
+void WavetableIndex::rescan()
+{
+    scanRequested = true;
+
+    if (isThreadRunning())
+        notify();
+    else
+        startThread (juce::Thread::Priority::low);
+}
+
+std::shared_ptr<const WavetableIndex::Snapshot> WavetableIndex::getSnapshot() const
+{
+    juce::SpinLock::ScopedLockType sl (snapshotLock);
+    return snapshot;
+}
+
+juce::Path WavetableIndex::createThumbnailPath (const Entry& e, juce::Rectangle<float> area)
+{
+    juce::Path p;
+
+    for (int i = 0; i < thumbPoints; i++)
+    {
+        auto x = area.getX() + area.getWidth() * float (i) / float (thumbPoints - 1);
+        auto y = area.getCentreY() - area.getHeight() * 0.5f * float (e.thumb[size_t (i)]) / 127.0f;
+
+        if (i == 0)
+            p.startNewSubPath (x, y);
+        else
+            p.lineTo (x, y);
+    }
+
+    return p;
+}
+
+//==============================================================================
+void WavetableIndex::run()
+{
+    while (! threadShouldExit())
+    {
+        if (! cacheLoaded)
+        {
+            loadCache();
+            cacheLoaded = true;
+        }
+
+        if (scanRequested.exchange (false))
+            doScan();
+
+        wait (-1);
+    }
+}
+
+void WavetableIndex::publish (std::vector<Entry> entries, bool complete)
+{
+    auto s = std::make_shared<Snapshot>();
+    s->entries = std::move (entries);
+    s->complete = complete;
+
+    std::shared_ptr<const Snapshot> old = std::move (s);
+    {
+        juce::SpinLock::ScopedLockType sl (snapshotLock);
+        std::swap (snapshot, old);
+    }
+}
+
+void WavetableIndex::doScan()
+{
+    WT_TRACE_SCOPE ("WavetableIndex scan");
+
+    juce::File factory, user, cache;
+    {
+        juce::ScopedLock sl (folderLock);
+        factory = factoryDir;
+        user = userDir;
+        cache = cacheFile;
+    }
+
+    // What we already know, by path
+    std::map<juce::String, const Entry*> known;
+    auto previous = getSnapshot();
+    for (auto& e : previous->entries)
+        known[e.file.getFullPathName()] = &e;
+
+    std::vector<Entry> entries;
+    std::vector<size_t> todo;
+
+    auto addFolder = [&] (const juce::File& dir, const juce::String& pattern, bool isUser)
+    {
+        if (! dir.isDirectory())
+            return;
+
+        for (const auto& it : juce::RangedDirectoryIterator (dir, true, pattern, juce::File::findFiles))
+        {
+            if (threadShouldExit())
+                return;
+
+            auto f = it.getFile();
+
+            Entry e;
+            e.file = f;
+            e.name = f.getFileNameWithoutExtension();
+            // User tables straight in the folder go at the top of the User menu
+            e.category = f.getParentDirectory() != dir ? f.getParentDirectory().getFileName() : isUser ? juce::String() : juce::String ("Other");
+            e.user = isUser;
+            e.modified = it.getModificationTime().toMilliseconds();
+            e.fileSize = it.getFileSize();
+
+            auto k = known.find (f.getFullPathName());
+            if (k != known.end() && k->second->modified == e.modified && k->second->fileSize == e.fileSize)
+            {
+                e.analysed = k->second->analysed;
+                e.tableSize = k->second->tableSize;
+                e.thumb = k->second->thumb;
+            }
+
+            entries.push_back (std::move (e));
+        }
+    };
+
+    addFolder (factory, "*.wt2048", false);
+    addFolder (user, "*.wav", true);
+
+    if (threadShouldExit())
+        return;
+
+    std::sort (entries.begin(), entries.end(), isBefore);
+
+    for (size_t i = 0; i < entries.size(); i++)
+        if (! entries[i].analysed)
+            todo.push_back (i);
+
+    bool changed = ! todo.empty() || entries.size() != previous->entries.size();
+
+    // Names first, so the browser can list new tables before their thumbnails are ready
+    publish (entries, todo.empty());
+
+    auto lastPublish = juce::Time::getMillisecondCounter();
+
+    for (size_t n = 0; n < todo.size(); n++)
+    {
+        if (threadShouldExit())
+            return;
+
+        analyse (entries[todo[n]]);
+
+        auto now = juce::Time::getMillisecondCounter();
+        if (now - lastPublish > 250 && n + 1 < todo.size())
+        {
+            publish (entries, false);
+            lastPublish = now;
+        }
+    }
+
+    if (! todo.empty())
+        publish (entries, true);
+
+    if (changed)
+        saveCache (*getSnapshot());
+}
+
+void WavetableIndex::analyse (Entry& e)
+{
+    e.analysed = true;
+    e.tableSize = 0;
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    int size = 0;
+
+    if (e.user)
+    {
+        size = gin::getWavetableSize (e.file);
+        reader.reset (juce::WavAudioFormat().createReaderFor (e.file.createInputStream().release(), true));
+
+        // Without metadata the size is asked for on load, the thumbnail
+        // assumes the usual 2048, or the whole file if it's shorter
+        if (size <= 0 && reader != nullptr)
+            size = int (std::min (juce::int64 (2048), reader->lengthInSamples));
+    }
+    else
+    {
+        size = 2048;
+        reader.reset (juce::FlacAudioFormat().createReaderFor (e.file.createInputStream().release(), true));
+    }
+
+    if (reader == nullptr || size <= 0)
+        return;
+
+    auto frames = int (reader->lengthInSamples / size);
+    if (frames <= 0)
+        return;
+
+    juce::AudioSampleBuffer buf (1, size);
+    reader->read (&buf, 0, size, juce::int64 (frames / 2) * size, true, false);
+
+    // Box average down to the thumbnail, then scale the peak to full height
+    std::array<float, thumbPoints> points {};
+    auto src = buf.getReadPointer (0);
+
+    for (int i = 0; i < thumbPoints; i++)
+    {
+        auto start = i * size / thumbPoints;
+        auto end = (i + 1) * size / thumbPoints;
+
+        float sum = 0.0f;
+        for (int j = start; j < end; j++)
+            sum += src[j];
+
+        points[size_t (i)] = sum / float (std::max (1, end - start));
+    }
+
+    float peak = 0.0f;
+    for (auto v : points)
+        peak = std::max (peak, std::abs (v));
+
+    for (int i = 0; i < thumbPoints; i++)
+        e.thumb[size_t (i)] = juce::int8 (peak > 0.0f ? juce::roundToInt (points[size_t (i)] / peak * 127.0f) : 0);
+
+    e.tableSize = size;
+}
+
+//==============================================================================
+void WavetableIndex::loadCache()
+{
+    juce::File cache;
+    {
+        juce::ScopedLock sl (folderLock);
+        cache = cacheFile;
+    }
+
+    juce::FileInputStream is (cache);
+    if (! is.openedOk())
+        return;
+
+    auto tree = juce::ValueTree::readFromStream (is);
+    if (! tree.hasType ("WavetableIndex") || int (tree.getProperty ("version")) != cacheVersion)
+        return;
+
+    std::vector<Entry> entries;
+
+    for (auto c : tree)
+    {
+        Entry e;
+        e.file = juce::File (c.getProperty ("path").toString());
+        e.name = e.file.getFileNameWithoutExtension();
+        e.category = c.getProperty ("category").toString();
+        e.user = c.getProperty ("user");
+        e.modified = c.getProperty ("modified");
+        e.fileSize = c.getProperty ("size");
+        e.analysed = c.getProperty ("analysed");
+        e.tableSize = c.getProperty ("tableSize");
+
+        if (auto mb = c.getProperty ("thumb").getBinaryData(); mb != nullptr && mb->getSize() == e.thumb.size())
+            std::memcpy (e.thumb.data(), mb->getData(), e.thumb.size());
+
+        entries.push_back (std::move (e));
+    }
+
+    std::sort (entries.begin(), entries.end(), isBefore);
+    publish (std::move (entries), false);
+}
+
+void WavetableIndex::saveCache (const Snapshot& s)
+{
+    juce::File cache;
+    {
+        juce::ScopedLock sl (folderLock);
+        cache = cacheFile;
+    }
+
+    if (cache == juce::File())
+        return;
+
+    juce::ValueTree tree ("WavetableIndex");
+    tree.setProperty ("version", cacheVersion, nullptr);
+
+    for (auto& e : s.entries)
+    {
+        juce::ValueTree c ("Table");
+        c.setProperty ("path", e.file.getFullPathName(), nullptr);
+        c.setProperty ("category", e.category, nullptr);
+        c.setProperty ("user", e.user, nullptr);
+        c.setProperty ("modified", e.modified, nullptr);
+        c.setProperty ("size", e.fileSize, nullptr);
+        c.setProperty ("analysed", e.analysed, nullptr);
+        c.setProperty ("tableSize", e.tableSize, nullptr);
+        c.setProperty ("thumb", juce::MemoryBlock (e.thumb.data(), e.thumb.size()), nullptr);
+        tree.appendChild (c, nullptr);
+    }
+
+    // Other instances may be reading it, so write it aside and swap it in
+    cache.getParentDirectory().createDirectory();
+
+    juce::TemporaryFile tmp (cache);
+    {
+        juce::FileOutputStream os (tmp.getFile());
+        if (! os.openedOk())
+            return;
+
+        tree.writeToStream (os);
+    }
+    tmp.overwriteTargetFileWithTemporary();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Everything the wavetable browser shows, kept up to date off the message
+    thread so the menu can be built straight from memory.
+
+    Factory tables are the .wt2048 files under the factory folder, user tables
+    any .wav under the user folder. Each gets a tiny thumbnail of its middle
+    frame. The index and thumbnails are cached in one file, so a scan only has
+    to decode tables that are new or have changed since the last one.
+
+    Shared by every plugin instance in the process through a
+    juce::SharedResourcePointer. Snapshots are immutable once published, the
+    scan publishes a new one as names and then thumbnails come in.
+*/
+class WavetableIndex : private juce::Thread
+{
+public:
+    static constexpr int thumbPoints = 48;
+
+    struct Entry
+    {
+        juce::File file;
+        juce::String name, category;
+        bool user = false;
+
+        juce::int64 modified = 0, fileSize = 0;
+
+        // Filled in once the table has been decoded. The samples per frame,
+        // a guess for user WAVs without wavetable metadata, 0 if it couldn't
+        // be read.
+        bool analysed = false;
+        int tableSize = 0;
+        std::array<juce::int8, thumbPoints> thumb {};
+    };
+
+    struct Snapshot
+    {
+        std::vector<Entry> entries;
+        bool complete = false;
+    };
+
+    WavetableIndex();
+    ~WavetableIndex() override;
+
+    /** Sets where the tables and the cache live and starts a scan */
+    void scan (const juce::File& factoryDir, const juce::File& userDir, const juce::File& cacheFile);
+
+    /** Looks for added, removed or changed tables in the background */
+    void rescan();
+
+    std::shared_ptr<const Snapshot> getSnapshot() const;
+
+    /** The thumbnail as a line through the given area */
+    static juce::Path createThumbnailPath (const Entry& e, juce::Rectangle<float> area);
+
+private:
+    void run() override;
+
+    void loadCache();
+    void saveCache (const Snapshot& s);
+    void doScan();
+    void publish (std::vector<Entry> entries, bool complete);
+
+    static void analyse (Entry& e);
+
+    juce::CriticalSection folderLock;
+    juce::File factoryDir, userDir, cacheFile;
+
+    mutable juce::SpinLock snapshotLock;
+    std::shared_ptr<const Snapshot> snapshot;
+
+    std::atomic<bool> scanRequested { false };
+    bool cacheLoaded = false;
+
+    JUCE_DECLARE_NON_COPYABLE (WavetableIndex)
+};
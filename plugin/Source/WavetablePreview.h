@@ -0,0 +1,54 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** A small copy of a wavetable for drawing: up to 64 frames spread across the
+    table, each averaged down to 256 points. Built once when the table loads
+    and never changed after, so the editor can hold on to one while the next
+    is loading.
+*/
+struct WavetablePreview
+{
+    static constexpr int maxFrames = 64;
+    static constexpr int maxFrameSize = 256;
+
+    static std::shared_ptr<const WavetablePreview> create (const juce::AudioSampleBuffer& frames, int size)
+    {
+        auto p = std::make_shared<WavetablePreview>();
+
+        const int numSourceFrames = size > 0 ? frames.getNumSamples() / size : 0;
+
+        p->numFrames = std::min (numSourceFrames, maxFrames);
+        p->frameSize = std::min (size, maxFrameSize);
+        p->data.resize (size_t (p->numFrames * p->frameSize));
+
+        auto src = frames.getReadPointer (0);
+
+        for (int f = 0; f < p->numFrames; f++)
+        {
+            auto frame = p->numFrames > 1 ? juce::roundToInt (f * (numSourceFrames - 1) / double (p->numFrames - 1)) : 0;
+            auto in = src + frame * size;
+            auto out = p->data.data() + f * p->frameSize;
+
+            for (int i = 0; i < p->frameSize; i++)
+            {
+                auto start = i * size / p->frameSize;
+                auto end = (i + 1) * size / p->frameSize;
+
+                float sum = 0.0f;
+                for (int j = start; j < end; j++)
+                    sum += in[j];
+
+                out[i] = sum / float (end - start);
+            }
+        }
+
+        return p;
+    }
+
+    const float* getFrame (int i) const     { return data.data() + i * frameSize; }
+
+    int numFrames = 0, frameSize = 0;
+    std::vector<float> data;
+};
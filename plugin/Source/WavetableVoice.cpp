@@ -188,12 +188,19 @@ void WavetableVoice::setCurrentSampleRate (double newRate)
 
     modStepLFO.setSampleRate (newRate);
     noteSmoother.setSampleRate (newRate);
+    smoothers.setSampleRate (newRate);
     adsr.setSampleRate (newRate);
 }
 
 void WavetableVoice::renderNextBlock (juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
 {
-    updateParams (numSamples);
+    WT_TRACE_SCOPE ("voiceRender");
+
+    {
+        ModProfiler::ScopedTimer t (proc.modProfiler, ModProfiler::voiceParams);
+        proc.modProfiler.addPolySlice();
+        updateParams (numSamples);
+    }
 
     // Run OSC
     gin::ScratchBuffer preFilter (2, numSamples);
@@ -239,15 +246,25 @@ void WavetableVoice::renderNextBlock (juce::AudioBuffer<float>& outputBuffer, in
     finishBlock (numSamples);
 }
 
+float WavetableVoice::getValue (gin::Parameter* p)
+{
+    auto v = gin::ModVoice::getValue (p);
+
+    if (disableSmoothing)
+        return smoothers.snap (p->getModIndex(), v);
+
+    return smoothers.process (p->getModIndex(), v);
+}
+
 void WavetableVoice::updateParams (int blockSize)
 {
+    smoothers.advance (blockSize);
+
     auto note = getCurrentlyPlayingNote();
     
     proc.modMatrix.setPolyValue (*this, proc.modSrcNote, note.initialNote / 127.0f);
     
-    double retuneSemitones = 0.0;
-    if (proc.mtsClient)
-        retuneSemitones = MTS_RetuningInSemitones (proc.mtsClient, note.initialNote, -1);
+    double retuneSemitones = proc.getRetuneSemitones (note.initialNote);
 
     for (int i = 0; i < Cfg::numOSCs; i++)
     {
@@ -470,20 +487,27 @@ bool WavetableVoice::isVoiceActive()
     return isActive();
 }
 
-float WavetableVoice::getFilterCutoffNormalized()
+void WavetableVoice::getTelemetry (VoiceTelemetry& t)
 {
+    t.active = isActive();
+    if (! t.active)
+        return;
+
+    t.note = getCurrentNote();
+
     float freq = filter.getFrequency();
     auto range = proc.filterParams.frequency->getUserRange();
-    return range.convertTo0to1 (juce::jlimit (range.start, range.end, gin::getMidiNoteFromHertz (freq)));
-}
+    t.cutoff = range.convertTo0to1 (juce::jlimit (range.start, range.end, gin::getMidiNoteFromHertz (freq)));
 
-gin::WTOscillator::Params WavetableVoice::getLiveWTParams (int osc)
-{
-    gin::WTOscillator::Params p;
-    p.position = getValue (proc.oscParams[osc].pos) / 100.0f;
-    p.formant = getValue (proc.oscParams[osc].formant);
-    p.bend = getValue (proc.oscParams[osc].bend);
-    return p;
+    t.envelope = adsr.getOutput();
+
+    // Already worked out for this block in updateParams()
+    for (int i = 0; i < Cfg::numOSCs; i++)
+    {
+        t.wt[i].position = oscParams[i].position;
+        t.wt[i].formant  = oscParams[i].formant;
+        t.wt[i].bend     = oscParams[i].bend;
+    }
 }
 
 float WavetableVoice::getCurrentNote()
@@ -2,7 +2,8 @@
 
 #include <JuceHeader.h>
 #include "Cfg.h"
-#include "MTS-ESP/Client/libMTSClient.h"
+#include "VoiceTelemetry.h"
+#include "ParamSmoothers.h"
 
 class WavetableAudioProcessor;
 
@@ -32,11 +33,14 @@ public:
 
     bool isVoiceActive() override;
 
-    float getFilterCutoffNormalized();
-    gin::WTOscillator::Params getLiveWTParams (int osc);
+    /** Audio thread only, the editor reads it through the processor's telemetry */
+    void getTelemetry (VoiceTelemetry& t);
 
     void updateParams (int blockSize);
 
+    /** The matrix value, smoothed if the parameter's policy is linear */
+    float getValue (gin::Parameter* p);
+
     WavetableAudioProcessor& proc;
 
     gin::WTVoicedStereoOscillator oscillators[Cfg::numOSCs];
@@ -60,6 +64,7 @@ public:
     gin::StereoOscillator::Params noiseParams;
     
     gin::EasedValueSmoother<float> noteSmoother;
+    LinearParamSmoothers smoothers;
     
     float ampKeyTrack = 1.0f;    
 };